@@ -0,0 +1,163 @@
+#define UTILZ_FLAT_MAP_STATS
+
+#include "catch.hpp"
+
+#include "utilz/flat-map.hpp"
+
+#include <iterator>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace utilz;
+
+TEST_CASE("FlatMap stats count lookups", "[lookups]")
+{
+    FlatMap<int, int> map;
+
+    for (int i(0); i < 10; ++i)
+    {
+        map.append(i, i);
+    }
+
+    CHECK(map.stats().peakSize == 10);
+    CHECK(map.stats().reallocations > 0);
+    CHECK(map.stats().lookups == 0);
+
+    CHECK(map.exists(0));
+    CHECK(map.at(9) == 9);
+    CHECK(map.find(100) == std::end(map));
+
+    const FlatMapStats stats{ map.stats() };
+    CHECK(stats.lookups == 3);
+    CHECK(stats.hits == 2);
+    CHECK(stats.misses == 1);
+    CHECK(stats.scanned == (1 + 10 + 10));
+    CHECK(stats.averageScanned() == Approx(7.0));
+
+    // operator[] both looks up and appends
+    map[10] = 10;
+    CHECK(map.stats().lookups == 4);
+    CHECK(map.stats().peakSize == 11);
+
+    // copies start from zero so nothing is counted twice
+    const FlatMap<int, int> copy{ map };
+    CHECK(copy.stats().lookups == 0);
+    CHECK(copy.exists(5));
+    CHECK(copy.stats().lookups == 1);
+}
+
+TEST_CASE("FlatMap stats count findMany() and atMany()", "[findMany/atMany]")
+{
+    FlatMap<int, int> map;
+
+    for (int i(0); i < 100; ++i)
+    {
+        map.append(i, i);
+    }
+
+    // few enough keys to be plain find() calls
+    const std::vector<int> few{ 3, 200 };
+    std::vector<FlatMap<int, int>::const_iterator_t> found;
+    std::as_const(map).findMany(std::begin(few), std::end(few), std::back_inserter(found));
+    CHECK(map.stats().lookups == 2);
+    CHECK(map.stats().hits == 1);
+
+    // enough keys for the merge, which counts every key too
+    std::vector<int> many;
+    for (int i(0); i < 20; ++i)
+    {
+        many.push_back(i * 10);
+    }
+
+    std::vector<int> data;
+    CHECK_THROWS(map.atMany(std::begin(many), std::end(many), std::back_inserter(data)));
+    CHECK(map.stats().lookups == 22);
+    CHECK(map.stats().hits == 11);
+    CHECK(map.stats().misses == 11);
+    CHECK(map.stats().scanned < (2 * 100) + (20 * 100));
+}
+
+TEST_CASE("FlatMap stats while many threads look up", "[threads]")
+{
+    FlatMap<int, int> map;
+
+    for (int i(0); i < 100; ++i)
+    {
+        map.append(i, i);
+    }
+
+    const FlatMap<int, int> & constMap{ map };
+    std::vector<std::thread> readers;
+    for (int t(0); t < 4; ++t)
+    {
+        readers.emplace_back([&]() {
+            for (int i(0); i < 1000; ++i)
+            {
+                constMap.exists(i % 100);
+            }
+        });
+    }
+
+    for (std::thread & reader : readers)
+    {
+        reader.join();
+    }
+
+    CHECK(map.stats().lookups == 4000);
+    CHECK(map.stats().hits == 4000);
+    CHECK(map.stats().scanned == (4 * 10 * (100 * 101 / 2)));
+}
+
+TEST_CASE("FlatMap stats report", "[report]")
+{
+    clearFlatMapStats();
+
+    {
+        FlatMap<std::string, int> slow;
+        slow.statsTag("slow");
+
+        for (int i(0); i < 100; ++i)
+        {
+            slow.append(std::to_string(i), i);
+        }
+
+        for (int i(0); i < 100; ++i)
+        {
+            slow.exists("missing");
+        }
+
+        FlatMap<std::string, int> fast;
+        fast.statsTag("fast");
+        fast["only"] = 1;
+        fast.exists("only");
+
+        // added to the report when destroyed
+    }
+
+    FlatMap<int, int> alive;
+    alive.statsTag("alive");
+    alive.exists(1);
+
+    const std::string beforeFlush{ flatMapStatsReport() };
+    CHECK(beforeFlush.find("alive") == std::string::npos);
+
+    alive.flushStats();
+    CHECK(alive.stats().lookups == 0);
+
+    const std::string report{ flatMapStatsReport() };
+    INFO(report);
+
+    // the worst average scan comes first
+    const auto slowPosition{ report.find("slow") };
+    const auto fastPosition{ report.find("fast") };
+    REQUIRE(slowPosition != std::string::npos);
+    REQUIRE(fastPosition != std::string::npos);
+    CHECK(slowPosition < fastPosition);
+    CHECK(report.find("alive") != std::string::npos);
+    CHECK(report.find("100.0") != std::string::npos);
+
+    clearFlatMapStats();
+    CHECK(flatMapStatsReport().find("slow") == std::string::npos);
+}
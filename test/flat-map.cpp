@@ -3,7 +3,16 @@
 #include "utilz/flat-map.hpp"
 
 #include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <memory_resource>
+#include <random>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 using namespace utilz;
 
@@ -272,3 +281,930 @@ TEST_CASE("sortAndUnique", "[sortAndUnique]")
 
     CHECK(map1 == map2);
 }
+
+TEST_CASE("SmallFlatMap", "[smallFlatMap]")
+{
+    SmallFlatMap<int, std::string, 4> map;
+
+    for (int i(0); i < 4; ++i)
+    {
+        map.append(i, std::to_string(i));
+    }
+
+    CHECK(map.size() == 4);
+    CHECK(map.capacity() == 4);
+    CHECK(map.at(3) == "3");
+
+    // spills to the heap
+    map[4] = "4";
+    CHECK(map.size() == 5);
+    CHECK(map.capacity() > 4);
+    CHECK(map.at(4) == "4");
+
+    map.erase(4);
+    map.shrinkToFit();
+    CHECK(map.capacity() == 4);
+
+    SmallFlatMap<int, std::string, 4> copy{ map };
+    CHECK(copy == map);
+
+    map.erase(0);
+    CHECK(copy != map);
+    CHECK(map.exists(0) == false);
+    CHECK(copy.exists(0));
+}
+
+namespace
+{
+    // counts what is allocated through it, and from where
+    class CountingResource : public std::pmr::memory_resource
+    {
+      public:
+        std::size_t allocationCount() const { return m_allocationCount; }
+
+      private:
+        void * do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+            ++m_allocationCount;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void * ptr, std::size_t bytes, std::size_t alignment) override
+        {
+            std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource & other) const noexcept override
+        {
+            return (this == &other);
+        }
+
+        std::size_t m_allocationCount{ 0 };
+    };
+} // namespace
+
+TEST_CASE("pmr::FlatMap", "[pmr]")
+{
+    CountingResource resource;
+
+    pmr::FlatMap<int, int> map{ std::pmr::polymorphic_allocator<std::pair<int, int>>(&resource) };
+    CHECK(map.getAllocator().resource() == &resource);
+
+    for (int i(0); i < 100; ++i)
+    {
+        map.append(i, i);
+    }
+
+    CHECK(resource.allocationCount() > 0);
+    CHECK(map.at(99) == 99);
+
+    // polymorphic_allocator does not propagate on copy
+    const pmr::FlatMap<int, int> copy{ map };
+    CHECK(copy.getAllocator().resource() != &resource);
+    CHECK(copy == map);
+
+    // but the allocator-extended constructors can put the copy anywhere
+    const pmr::FlatMap<int, int> copyInResource{ map, map.getAllocator() };
+    CHECK(copyInResource.getAllocator().resource() == &resource);
+    CHECK(copyInResource == map);
+
+    // maps nested in pmr containers use the same resource
+    std::pmr::vector<pmr::FlatMap<int, int>> maps{ &resource };
+    maps.emplace_back();
+    CHECK(maps.back().getAllocator().resource() == &resource);
+
+    pmr::FlatMap<int, int> other{ std::pmr::polymorphic_allocator<std::pair<int, int>>(&resource) };
+    other.append(1000, 1000);
+    swap(map, other);
+    CHECK(map.size() == 1);
+    CHECK(other.size() == 100);
+
+    // the tombstones come from the same resource, nothing is allocated from the default one
+    std::pmr::memory_resource * const defaultResource{ std::pmr::get_default_resource() };
+    std::pmr::set_default_resource(std::pmr::null_memory_resource());
+
+    const std::size_t allocationsBefore{ resource.allocationCount() };
+    other.markErased(50);
+    CHECK(resource.allocationCount() > allocationsBefore);
+
+    const pmr::FlatMap<int, int> marksCopy{ other, other.getAllocator() };
+    CHECK(marksCopy.exists(50) == false);
+
+    std::pmr::set_default_resource(defaultResource);
+}
+
+TEST_CASE("FlatMap with a custom allocator", "[allocator]")
+{
+    using allocator_t = std::allocator<std::pair<int, int>>;
+
+    FlatMap<int, int, std::vector<std::pair<int, int>, allocator_t>> map{ allocator_t() };
+    map[1] = 1;
+
+    FlatMap<int, int, std::vector<std::pair<int, int>, allocator_t>> moved{ std::move(map),
+                                                                            allocator_t() };
+
+    CHECK(moved.at(1) == 1);
+    CHECK(std::is_same_v<decltype(moved)::allocator_type, allocator_t>);
+    CHECK(std::is_same_v<SmallFlatMap<int, int, 2>::allocator_type, void>);
+}
+
+namespace
+{
+    // counts how many times a key had to be constructed
+    struct CountedKey
+    {
+        explicit CountedKey(const std::string_view view)
+            : name(view)
+        {
+            ++constructCount;
+        }
+
+        std::string name;
+
+        static inline int constructCount{ 0 };
+    };
+
+    bool operator==(const CountedKey & key, const std::string_view view)
+    {
+        return (key.name == view);
+    }
+} // namespace
+
+TEST_CASE("heterogeneous lookup", "[heterogeneous]")
+{
+    FlatMap<std::string, int> map;
+
+    map["zero"] = 0;
+    map[std::string_view("one")] = 1;
+    map.append("two", 2);
+
+    const std::string_view two{ "two" };
+    const char * const one{ "one" };
+
+    CHECK(map.at(two) == 2);
+    CHECK(map.at(one) == 1);
+    CHECK(map.find(two)->second == 2);
+    CHECK(map.exists(std::string_view("three")) == false);
+    CHECK(std::as_const(map).at(two) == 2);
+    CHECK(std::as_const(map).find(one) != std::end(map));
+
+    map.erase(two);
+    CHECK(map.size() == 2);
+    CHECK(map.exists("two") == false);
+
+    FlatMap<CountedKey, int> counted;
+    counted[std::string_view("a")] = 1;
+    CHECK(CountedKey::constructCount == 1);
+
+    counted[std::string_view("a")] = 2;
+    CHECK(counted.at(std::string_view("a")) == 2);
+    CHECK(counted.exists(std::string_view("b")) == false);
+    CHECK(CountedKey::constructCount == 1);
+
+    // plain numbers still convert to the key like they always have
+    FlatMap<std::size_t, int> sizes;
+    sizes[0] = 1;
+    CHECK(sizes.at(0) == 1);
+}
+
+namespace
+{
+    // counts copies so tests can tell when something was moved instead
+    struct Heavy
+    {
+        Heavy() = default;
+
+        explicit Heavy(const int number)
+            : value(number)
+        {}
+
+        Heavy(const Heavy & other)
+            : value(other.value)
+        {
+            ++copyCount;
+        }
+
+        Heavy(Heavy &&) = default;
+
+        Heavy & operator=(const Heavy & other)
+        {
+            value = other.value;
+            ++copyCount;
+            return *this;
+        }
+
+        Heavy & operator=(Heavy &&) = default;
+
+        int value{ 0 };
+
+        static inline int copyCount{ 0 };
+    };
+} // namespace
+
+TEST_CASE("emplace/tryEmplace/insertOrAssign/move append", "[emplace]")
+{
+    FlatMap<std::string, Heavy> map;
+
+    map.append("one", Heavy(1));
+    map.append(std::make_pair(std::string("two"), Heavy(2)));
+    map.emplace("three", Heavy(3));
+    map.emplace(std::piecewise_construct, std::forward_as_tuple("four"), std::forward_as_tuple(4));
+
+    const std::string five{ "five" };
+    Heavy heavyFive(5);
+    map.append(five, std::move(heavyFive));
+
+    CHECK(map.size() == 5);
+    CHECK(map.at("four").value == 4);
+    CHECK(map.at("five").value == 5);
+
+    auto result{ map.tryEmplace("one", 100) };
+    CHECK(result.second == false);
+    CHECK(result.first->second.value == 1);
+
+    result = map.tryEmplace("six", 6);
+    CHECK(result.second);
+    CHECK(result.first->second.value == 6);
+
+    result = map.insertOrAssign("one", Heavy(10));
+    CHECK(result.second == false);
+    CHECK(map.at("one").value == 10);
+
+    result = map.insertOrAssign(std::string("seven"), Heavy(7));
+    CHECK(result.second);
+    CHECK(map.at("seven").value == 7);
+
+    map[std::string("eight")].value = 8;
+    CHECK(map.at("eight").value == 8);
+    CHECK(map.size() == 8);
+
+    // none of the above should have copied a Heavy
+    CHECK(Heavy::copyCount == 0);
+
+    map.append("nine", {});
+    CHECK(map.at("nine").value == 0);
+}
+
+TEST_CASE("compares ignore order", "[comparesOrder]")
+{
+    FlatMap<int, int> sorted;
+    FlatMap<int, int> reversed;
+
+    // more than fits in the compare's inline buffer
+    for (int i(0); i < 100; ++i)
+    {
+        sorted.append(i, i);
+        reversed.append((99 - i), (99 - i));
+    }
+
+    CHECK(sorted == reversed);
+    CHECK(reversed == sorted);
+    CHECK((sorted < reversed) == false);
+    CHECK((reversed < sorted) == false);
+
+    // same front, different order at the end
+    FlatMap<int, int> map1;
+    FlatMap<int, int> map2;
+
+    map1.append(7, 0);
+    map1.append(1, 0);
+    map1.append(2, 0);
+
+    map2.append(7, 0);
+    map2.append(2, 0);
+    map2.append(1, 0);
+
+    CHECK(map1 == map2);
+
+    map2.append(1, 0);
+    map1.append(2, 0);
+    CHECK(map1 != map2);
+    CHECK(map2 < map1);
+    CHECK(map1 > map2);
+
+    // the left being sorted and the right not must still work
+    FlatMap<int, int> map3;
+    map3.append(1, 0);
+    map3.append(2, 0);
+    map3.append(7, 0);
+
+    FlatMap<int, int> map4;
+    map4.append(7, 0);
+    map4.append(1, 0);
+    map4.append(3, 0);
+
+    CHECK(map3 != map4);
+    CHECK(map3 < map4);
+    CHECK(map4 > map3);
+
+    // duplicate keys with their data in a different order are still the same entries
+    FlatMap<int, int> dupes1;
+    dupes1.append(1, 10);
+    dupes1.append(1, 11);
+    dupes1.append(0, 0);
+
+    FlatMap<int, int> dupes2;
+    dupes2.append(0, 0);
+    dupes2.append(1, 11);
+    dupes2.append(1, 10);
+
+    CHECK(dupes1 == dupes2);
+    CHECK((dupes1 < dupes2) == false);
+    CHECK((dupes2 < dupes1) == false);
+
+    dupes2.append(1, 10);
+    dupes1.append(1, 11);
+    CHECK(dupes1 != dupes2);
+}
+
+TEST_CASE("operator== only needs operator== of the data", "[comparesEquality]")
+{
+    // no operator<
+    struct Data
+    {
+        int value;
+
+        bool operator==(const Data & other) const { return (value == other.value); }
+    };
+
+    FlatMap<int, Data> left;
+    FlatMap<int, Data> right;
+
+    for (int i(0); i < 100; ++i)
+    {
+        left.append(i, Data{ i });
+        right.append((99 - i), Data{ 99 - i });
+    }
+
+    CHECK(left == right);
+
+    right.append(100, Data{ 0 });
+    left.append(100, Data{ 1 });
+    CHECK(left != right);
+}
+
+TEST_CASE("insertRange/assignFrom", "[insertRange/assignFrom]")
+{
+    const std::vector<std::pair<int, int>> pairs{ { 3, 1 }, { 1, 1 }, { 3, 2 }, { 2, 1 }, { 3, 3 } };
+
+    FlatMap<int, int> map;
+    map.append(2, 0);
+
+    map.insertRange(std::begin(pairs), std::end(pairs));
+    CHECK(map.size() == 3);
+    CHECK(std::is_sorted(std::begin(map), std::end(map)));
+    CHECK(map.at(1) == 1);
+    CHECK(map.at(2) == 0); // what was in the map first wins
+    CHECK(map.at(3) == 1);
+
+    map.assignFrom(pairs, Duplicates::KeepLast);
+    CHECK(map.size() == 3);
+    CHECK(map.at(2) == 1);
+    CHECK(map.at(3) == 3);
+
+    map.assignFrom(pairs, [](int & sum, int && more) { sum += more; });
+    CHECK(map.size() == 3);
+    CHECK(map.at(1) == 1);
+    CHECK(map.at(3) == 6);
+
+    map.assignFrom(std::vector<std::pair<int, int>>{});
+    CHECK(map.empty());
+
+    FlatMap<std::string, int> big;
+    std::vector<std::pair<std::string, int>> many;
+    for (int i(0); i < 10'000; ++i)
+    {
+        many.emplace_back(std::to_string(i % 1000), i);
+    }
+
+    big.insertRange(std::begin(many), std::end(many), Duplicates::KeepLast);
+    CHECK(big.size() == 1000);
+    CHECK(big.at("7") == 9007);
+}
+
+namespace
+{
+    enum class Level : short
+    {
+        Low = -100,
+        Mid = 0,
+        High = 100
+    };
+
+    // checks that sortAndUnique() kept the first entry for each key and sorted by key
+    template <typename key_t>
+    void checkSortAndUniqueKeepsFirst(const std::vector<key_t> & keys)
+    {
+        FlatMap<key_t, std::size_t> map;
+        std::map<key_t, std::size_t> expected;
+
+        for (std::size_t i(0); i < keys.size(); ++i)
+        {
+            map.append(keys[i], i);
+            expected.emplace(keys[i], i);
+        }
+
+        map.sortAndUnique();
+
+        REQUIRE(map.size() == expected.size());
+        REQUIRE(std::is_sorted(std::begin(map), std::end(map), [](const auto & a, const auto & b) {
+            return (a.first < b.first);
+        }));
+
+        REQUIRE(std::equal(
+            std::begin(map),
+            std::end(map),
+            std::begin(expected),
+            [](const auto & pair, const auto & expectedPair) {
+                return (
+                    (pair.first == expectedPair.first) && (pair.second == expectedPair.second));
+            }));
+    }
+} // namespace
+
+TEST_CASE("sortAndUnique radix and parallel sorts", "[sortAndUniqueLarge]")
+{
+    std::mt19937 engine(123);
+
+    std::vector<int> ints;
+    std::vector<std::uint64_t> bigs;
+    std::vector<signed char> chars;
+    std::vector<Level> levels;
+
+    for (std::size_t i(0); i < 5000; ++i)
+    {
+        ints.push_back(std::uniform_int_distribution<int>(-2000, 2000)(engine));
+        bigs.push_back(std::uniform_int_distribution<std::uint64_t>()(engine) % 3000);
+        chars.push_back(
+            static_cast<signed char>(std::uniform_int_distribution<int>(-128, 127)(engine)));
+        levels.push_back(static_cast<Level>((static_cast<int>(i % 3) - 1) * 100));
+    }
+
+    checkSortAndUniqueKeepsFirst(ints);
+    checkSortAndUniqueKeepsFirst(bigs);
+    checkSortAndUniqueKeepsFirst(chars);
+    checkSortAndUniqueKeepsFirst(levels);
+
+    std::vector<std::string> strings;
+    for (std::size_t i(0); i < (FlatMap<std::string, int>::parallelSortMinSize + 10); ++i)
+    {
+        strings.push_back(std::to_string(std::uniform_int_distribution<int>(0, 50'000)(engine)));
+    }
+
+    checkSortAndUniqueKeepsFirst(strings);
+}
+
+TEST_CASE("eraseUnordered", "[eraseUnordered]")
+{
+    FlatMap<int, std::string> map;
+
+    for (int i(0); i < 5; ++i)
+    {
+        map.append(i, std::to_string(i));
+    }
+
+    map.append(2, "duplicate");
+
+    // the last entry moves into the hole
+    const auto iter{ map.eraseUnordered(map.find(1)) };
+    CHECK(iter->first == 2);
+    CHECK(iter->second == "duplicate");
+    CHECK(map.size() == 5);
+    CHECK(map.exists(1) == false);
+
+    const auto lastIter{ map.eraseUnordered(std::prev(std::end(map))) };
+    CHECK(lastIter == std::end(map));
+    CHECK(map.size() == 4);
+
+    map.eraseUnordered(2);
+    CHECK(map.exists(2) == false);
+    CHECK(map.size() == 2);
+    CHECK(map.at(0) == "0");
+    CHECK(map.at(3) == "3");
+
+    map.eraseUnordered(99);
+    CHECK(map.size() == 2);
+}
+
+TEST_CASE("markErased/compact", "[markErased/compact]")
+{
+    FlatMap<int, int> map;
+
+    for (int i(0); i < 10; ++i)
+    {
+        map.append(i, (i * 10));
+    }
+
+    map.append(4, 99);
+
+    map.markErased(4);
+    map.markErased(map.find(7));
+    map.markErased(7); // already marked
+
+    CHECK(map.markedCount() == 3);
+    CHECK(map.size() == 11);
+    CHECK(map.exists(4) == false);
+    CHECK(map.find(7) == std::end(map));
+    CHECK_THROWS(map.at(4));
+    CHECK(map.isMarkedErased(std::begin(map) + 4));
+    CHECK(map.isMarkedErased(std::begin(map) + 5) == false);
+
+    // operator[] appends a new entry instead of reviving the tombstone
+    map[7] = 700;
+    CHECK(map.size() == 12);
+    CHECK(map.at(7) == 700);
+
+    // the marks have to follow the entries through all the other kinds of erase
+    map.eraseUnordered(std::begin(map) + 4);
+    CHECK(map.markedCount() == 2);
+    CHECK(map.at(7) == 700);
+
+    map.erase(std::begin(map));
+    CHECK(map.markedCount() == 2);
+    CHECK(map.exists(4) == false);
+
+    map.compact();
+    CHECK(map.markedCount() == 0);
+    CHECK(map.size() == 8);
+    CHECK(map.exists(4) == false);
+    CHECK(map.at(7) == 700);
+
+    const std::vector<int> keys{ 1, 2, 3, 7, 5, 6, 8, 9 };
+    CHECK(std::equal(
+        std::begin(map), std::end(map), std::begin(keys), [](const auto & pair, const int key) {
+            return (pair.first == key);
+        }));
+
+    // erase(key) compacts too
+    map.markErased(1);
+    map.erase(2);
+    CHECK(map.markedCount() == 0);
+    CHECK(map.size() == 6);
+    CHECK(map.begin()->first == 3);
+}
+
+TEST_CASE("findMany/atMany", "[findMany/atMany]")
+{
+    std::mt19937 engine(456);
+
+    FlatMap<int, int> map;
+    for (int i(0); i < 2000; ++i)
+    {
+        map.append(std::uniform_int_distribution<int>(0, 3000)(engine), i);
+    }
+
+    map.markErased(map.begin()->first);
+
+    std::vector<int> keys;
+    for (int i(0); i < 500; ++i)
+    {
+        keys.push_back(std::uniform_int_distribution<int>(-100, 3100)(engine));
+    }
+
+    keys.push_back(map.begin()->first);
+
+    // the same as calling find() on each key, no matter the duplicates and tombstones
+    std::vector<FlatMap<int, int>::iterator_t> found;
+    map.findMany(std::begin(keys), std::end(keys), std::back_inserter(found));
+
+    REQUIRE(found.size() == keys.size());
+    for (std::size_t i(0); i < keys.size(); ++i)
+    {
+        REQUIRE(found[i] == map.find(keys[i]));
+    }
+
+    // too few keys for a map this big to be worth sorting it, so these are each a find()
+    std::vector<FlatMap<int, int>::iterator_t> someFound;
+    map.findMany(std::begin(keys), (std::begin(keys) + 12), std::back_inserter(someFound));
+    REQUIRE(someFound.size() == 12);
+    for (std::size_t i(0); i < someFound.size(); ++i)
+    {
+        REQUIRE(someFound[i] == map.find(keys[i]));
+    }
+
+    // a sorted map is binary searched instead, with duplicates next to each other
+    FlatMap<int, int> sorted;
+    for (int i(0); i < 3000; ++i)
+    {
+        sorted.append((i / 3), i);
+    }
+
+    std::vector<FlatMap<int, int>::const_iterator_t> sortedFound;
+    std::as_const(sorted).findMany(
+        std::begin(keys), std::end(keys), std::back_inserter(sortedFound));
+
+    REQUIRE(sortedFound.size() == keys.size());
+    for (std::size_t i(0); i < keys.size(); ++i)
+    {
+        REQUIRE(sortedFound[i] == std::as_const(sorted).find(keys[i]));
+    }
+
+    // too few keys to bother sorting
+    const std::vector<int> fewKeys{ keys[0], keys[1], -1 };
+    std::vector<FlatMap<int, int>::const_iterator_t> fewFound(fewKeys.size());
+    const FlatMap<int, int> & constMap{ map };
+    constMap.findMany(std::begin(fewKeys), std::end(fewKeys), std::begin(fewFound));
+    CHECK(fewFound[0] == constMap.find(keys[0]));
+    CHECK(fewFound[2] == std::end(constMap));
+
+    // heterogeneous keys
+    FlatMap<std::string, int> names;
+    std::vector<std::string_view> views;
+    for (int i(0); i < 20; ++i)
+    {
+        names.append(std::to_string(i), i);
+    }
+
+    for (auto iter(names.rbegin()); iter != names.rend(); ++iter)
+    {
+        views.emplace_back(iter->first);
+    }
+
+    std::vector<int> values;
+    names.atMany(std::begin(views), std::end(views), std::back_inserter(values));
+    REQUIRE(values.size() == 20);
+    CHECK(values.front() == 19);
+    CHECK(values.back() == 0);
+
+    views.push_back("missing");
+    values.clear();
+    CHECK_THROWS(names.atMany(std::begin(views), std::end(views), std::back_inserter(values)));
+    CHECK(values.empty());
+}
+
+TEST_CASE("merge/intersectKeys/subtractKeys", "[merge/intersectKeys/subtractKeys]")
+{
+    FlatMap<int, int> left;
+    left.append(3, 30);
+    left.append(1, 10);
+    left.append(3, 31); // lookups never see this one
+    left.append(5, 50);
+
+    FlatMap<int, int> right;
+    right.append(4, 4);
+    right.append(3, 3);
+    right.append(2, 2);
+    right.append(9, 9);
+    right.markErased(9);
+
+    FlatMap<int, int> merged{ left };
+    merged.merge(right);
+    CHECK(merged.size() == 6);
+    CHECK(merged.at(3) == 30);
+    CHECK(merged.at(2) == 2);
+    CHECK(merged.at(4) == 4);
+    CHECK(merged.exists(9) == false);
+
+    // the order is kept and what is new goes on the end in key order
+    CHECK(std::next(std::begin(merged), 4)->first == 2);
+    CHECK(std::next(std::begin(merged), 5)->first == 4);
+
+    merged = left;
+    merged.merge(right, Duplicates::KeepLast);
+    CHECK(merged.at(3) == 3);
+
+    merged = left;
+    merged.merge(right, [](int & kept, const int & other) { kept += other; });
+    CHECK(merged.at(3) == 33);
+    CHECK(merged.at(1) == 10);
+
+    // sorted maps stay sorted
+    FlatMap<int, int> sorted;
+    sorted.append(1, 1);
+    sorted.append(5, 5);
+    sorted.merge(right);
+    CHECK(std::is_sorted(std::begin(sorted), std::end(sorted)));
+    CHECK(sorted.size() == 5);
+
+    // maps with different storage can be merged
+    SmallFlatMap<int, int, 4> small;
+    small.append(7, 7);
+    small.merge(left);
+    CHECK(small.size() == 4);
+
+    FlatMap<int, int> intersected{ left };
+    intersected.intersectKeys(right);
+    REQUIRE(intersected.size() == 2);
+    CHECK(std::begin(intersected)->second == 30);
+    CHECK(std::next(std::begin(intersected))->second == 31);
+
+    FlatMap<int, int> subtracted{ left };
+    subtracted.subtractKeys(right);
+    REQUIRE(subtracted.size() == 2);
+    CHECK(std::begin(subtracted)->first == 1);
+    CHECK(std::next(std::begin(subtracted))->first == 5);
+
+    subtracted.subtractKeys(subtracted);
+    CHECK(subtracted.empty());
+
+    left.intersectKeys(FlatMap<int, int>());
+    CHECK(left.empty());
+}
+
+TEST_CASE("diff", "[diff]")
+{
+    std::mt19937 engine(2023);
+    std::uniform_int_distribution<int> keys(0, 2000);
+
+    FlatMap<int, int> before;
+    for (int i(0); i < 1000; ++i)
+    {
+        before[keys(engine)] = 0;
+    }
+
+    FlatMap<int, int> after{ before };
+    std::map<int, int> expectedAdded;
+    std::map<int, int> expectedRemoved;
+    std::map<int, int> expectedChanged;
+
+    for (const auto & [key, value] : before)
+    {
+        const int roll{ keys(engine) % 3 };
+
+        if (0 == roll)
+        {
+            after.erase(key);
+            expectedRemoved[key] = value;
+        }
+        else if (1 == roll)
+        {
+            after[key] = 1;
+            expectedChanged[key] = 1;
+        }
+    }
+
+    for (int i(0); i < 100; ++i)
+    {
+        const int key{ 3000 + keys(engine) };
+
+        if (!after.exists(key))
+        {
+            after[key] = 2;
+            expectedAdded[key] = 2;
+        }
+    }
+
+    const auto check{ [&](const FlatMapDiff<int, int> & result) {
+        CHECK(result.empty() == false);
+        CHECK(
+            result.added ==
+            std::vector<std::pair<int, int>>(std::begin(expectedAdded), std::end(expectedAdded)));
+
+        CHECK(
+            result.removed == std::vector<std::pair<int, int>>(
+                                  std::begin(expectedRemoved), std::end(expectedRemoved)));
+
+        CHECK(
+            result.changed == std::vector<std::pair<int, int>>(
+                                  std::begin(expectedChanged), std::end(expectedChanged)));
+    } };
+
+    check(diff(before, after));
+
+    // the same once they are sorted, which skips the sorting in diff()
+    before.sortAndUnique();
+    after.sortAndUnique();
+    check(diff(before, after));
+
+    CHECK(diff(before, before).empty());
+    CHECK(diff(FlatMap<int, int>(), FlatMap<int, int>()).empty());
+}
+
+TEST_CASE("extract/insert/extractIf", "[extract/insert/extractIf]")
+{
+    FlatMap<std::string, std::string> zone;
+    zone.append("a", "1");
+    zone.append("b", "2");
+    zone.append("c", "3");
+    zone.append("d", "4");
+
+    FlatMap<std::string, std::string> otherZone;
+    otherZone.append("c", "other");
+
+    auto node{ zone.extract("b") };
+    REQUIRE(node);
+    CHECK(node.key() == "b");
+    CHECK(node.data() == "2");
+    CHECK(zone.size() == 3);
+    CHECK(std::next(std::begin(zone))->first == "c"); // the order is kept
+
+    CHECK(zone.extract("missing").empty());
+
+    const auto [iter, wasInserted] = otherZone.insert(std::move(node));
+    CHECK(wasInserted);
+    CHECK(iter->first == "b");
+    CHECK(node.empty());
+    CHECK(otherZone.at("b") == "2");
+    CHECK(otherZone.insert(std::move(node)).second == false);
+
+    auto duplicate{ zone.extractUnordered(zone.find("c")) };
+    CHECK(zone.size() == 2);
+    CHECK(std::next(std::begin(zone))->first == "d");
+
+    // the key is already there so the node keeps its entry
+    CHECK(otherZone.insert(std::move(duplicate)).second == false);
+    REQUIRE(duplicate);
+    CHECK(duplicate.data() == "3");
+    CHECK(otherZone.at("c") == "other");
+
+    // nodes work between maps with different storage
+    SmallFlatMap<std::string, std::string, 2> small;
+    CHECK(small.insert(zone.extractUnordered("a")).second);
+    CHECK(small.at("a") == "1");
+    CHECK(zone.size() == 1);
+}
+
+TEST_CASE("extractIf", "[extractIf]")
+{
+    FlatMap<int, std::string> map;
+    for (int i(0); i < 10; ++i)
+    {
+        map.append(i, std::to_string(i));
+    }
+
+    map.markErased(4);
+
+    std::vector<std::pair<int, std::string>> extracted;
+    map.extractIf(
+        [](const auto & pair) { return (0 == (pair.first % 2)); }, std::back_inserter(extracted));
+
+    // the tombstone is gone but was not extracted
+    const std::vector<std::pair<int, std::string>> expected{
+        { 0, "0" }, { 2, "2" }, { 6, "6" }, { 8, "8" }
+    };
+
+    CHECK(extracted == expected);
+    CHECK(map.size() == 5);
+    CHECK(map.markedCount() == 0);
+
+    std::vector<int> keys;
+    for (const auto & pair : map)
+    {
+        keys.push_back(pair.first);
+    }
+
+    CHECK(keys == std::vector<int>{ 1, 3, 5, 7, 9 });
+}
+
+TEST_CASE("eraseIf/eraseKeys", "[eraseIf/eraseKeys]")
+{
+    FlatMap<int, int> map;
+    for (int i(0); i < 100; ++i)
+    {
+        map.append(i, (i * 10));
+    }
+
+    map.append(50, 0);
+    map.markErased(1);
+
+    map.eraseIf([](const auto & pair) { return (pair.second >= 900); });
+    CHECK(map.size() == 90);
+    CHECK(map.markedCount() == 0);
+    CHECK(map.exists(89));
+    CHECK(map.exists(90) == false);
+
+    const std::vector<int> expired{ 70, 5, 50, 1000, 5 };
+    map.eraseKeys(std::begin(expired), std::end(expired));
+    CHECK(map.size() == 86);
+    CHECK(map.exists(5) == false);
+    CHECK(map.exists(50) == false); // and its duplicate
+    CHECK(map.exists(70) == false);
+
+    // the order of what is left is kept
+    CHECK(std::is_sorted(std::begin(map), std::end(map)));
+
+    map.eraseKeys(std::begin(expired), std::begin(expired));
+    CHECK(map.size() == 86);
+
+    FlatMap<std::string, int> names;
+    names.append("alpha", 1);
+    names.append("beta", 2);
+    names.append("gamma", 3);
+
+    const std::vector<std::string_view> doomed{ "gamma", "alpha", "delta" };
+    names.eraseKeys(std::begin(doomed), std::end(doomed));
+    REQUIRE(names.size() == 1);
+    CHECK(names.exists("beta"));
+
+    // const char * sorts by address, so the keys have to be sorted as std::strings instead
+    FlatMap<std::string, int> letters;
+    for (const char * letter : { "d", "a", "c", "b", "e" })
+    {
+        letters.append(letter, 0);
+    }
+
+    const char * const pointers[]{ "e", "a", "c" };
+    letters.eraseKeys(std::begin(pointers), std::end(pointers));
+
+    std::vector<std::string> left;
+    for (const auto & pair : letters)
+    {
+        left.push_back(pair.first);
+    }
+
+    CHECK(left == std::vector<std::string>{ "d", "b" });
+
+    const std::vector<std::string_view> views{ "d", "x", "b" };
+    letters.eraseKeys(std::begin(views), std::end(views));
+    CHECK(letters.empty());
+}
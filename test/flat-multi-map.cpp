@@ -0,0 +1,150 @@
+#include "catch.hpp"
+
+#include "utilz/flat-multi-map.hpp"
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace utilz;
+
+TEST_CASE("FlatMultiMap Default Constructor Creates Empty Container", "[defaultConstructor]")
+{
+    const FlatMultiMap<int, int> map;
+
+    CHECK(map.empty());
+    CHECK(map.size() == 0);
+    CHECK(map.count(0) == 0);
+    CHECK(map.exists(0) == false);
+    CHECK(map.find(0) == std::end(map));
+    CHECK(map.groupCount() == 0);
+    CHECK(map.groups().begin() == map.groups().end());
+}
+
+TEST_CASE("FlatMultiMap insert keeps keys together in insertion order", "[insert]")
+{
+    FlatMultiMap<int, std::string> map;
+    map.insert(2, "b1");
+    map.insert(1, "a1");
+    map.insert(2, "b2");
+    map.insert(3, "c1");
+    map.insert(1, "a2");
+    map.insert(2, "b3");
+
+    REQUIRE(map.size() == 6);
+    CHECK(map.count(1) == 2);
+    CHECK(map.count(2) == 3);
+    CHECK(map.count(3) == 1);
+    CHECK(map.count(4) == 0);
+    CHECK(map.exists(3));
+    CHECK(map.exists(0) == false);
+    CHECK(map.find(2)->second == "b1");
+
+    const std::vector<std::string> expected{ "a1", "a2", "b1", "b2", "b3", "c1" };
+    std::vector<std::string> actual;
+    for (const auto & [key, value] : map)
+    {
+        actual.push_back(value);
+    }
+
+    CHECK(actual == expected);
+
+    const auto [first, last] = map.equalRange(2);
+    REQUIRE((last - first) == 3);
+    CHECK(first->second == "b1");
+    CHECK((last - 1)->second == "b3");
+
+    CHECK(map.erase(2) == 3);
+    CHECK(map.size() == 3);
+    CHECK(map.exists(2) == false);
+    CHECK(map.erase(2) == 0);
+}
+
+TEST_CASE("FlatMultiMap insertRange", "[insertRange]")
+{
+    FlatMultiMap<int, int> map;
+    map.insert(5, 0);
+    map.insert(1, 0);
+
+    const std::vector<std::pair<int, int>> more{ { 5, 1 }, { 3, 1 }, { 1, 1 }, { 5, 2 } };
+    map.insertRange(std::begin(more), std::end(more));
+
+    const std::vector<std::pair<int, int>> expected{ { 1, 0 }, { 1, 1 }, { 3, 1 },
+                                                     { 5, 0 }, { 5, 1 }, { 5, 2 } };
+
+    CHECK(std::equal(std::begin(map), std::end(map), std::begin(expected), std::end(expected)));
+}
+
+TEST_CASE("FlatMultiMap groups", "[groups]")
+{
+    std::mt19937 engine(2021);
+    std::uniform_int_distribution<int> keys(0, 99);
+
+    std::vector<std::pair<int, int>> events;
+    std::map<int, std::vector<int>> expected;
+    for (int i(0); i < 5000; ++i)
+    {
+        const int key{ keys(engine) };
+        events.emplace_back(key, i);
+        expected[key].push_back(i);
+    }
+
+    FlatMultiMap<int, int> map;
+    map.insertRange(std::begin(events), std::end(events));
+
+    REQUIRE(map.groupCount() == expected.size());
+
+    auto expectedIter{ std::begin(expected) };
+    for (const auto & group : map.groups())
+    {
+        REQUIRE(group.key() == expectedIter->first);
+        REQUIRE(group.size() == expectedIter->second.size());
+
+        std::vector<int> values;
+        for (const auto & pair : group)
+        {
+            values.push_back(pair.second);
+        }
+
+        REQUIRE(values == expectedIter->second);
+        ++expectedIter;
+    }
+
+    // the non-const groups can change values
+    for (const auto & group : map.groups())
+    {
+        for (auto & pair : group)
+        {
+            pair.second = group.key();
+        }
+    }
+
+    CHECK(std::all_of(std::begin(map), std::end(map), [](const auto & pair) {
+        return (pair.first == pair.second);
+    }));
+}
+
+TEST_CASE("FlatMultiMap compares", "[compares]")
+{
+    FlatMultiMap<int, int> left;
+    left.insert(1, 1);
+    left.insert(1, 2);
+
+    FlatMultiMap<int, int> right;
+    right.insert(1, 2);
+    right.insert(1, 1);
+
+    // the order within a key counts
+    CHECK(left != right);
+    CHECK(left < right);
+    CHECK(right > left);
+
+    right.erase(1);
+    right.insert(1, 1);
+    right.insert(1, 2);
+    CHECK(left == right);
+    CHECK(left <= right);
+    CHECK(left >= right);
+}
@@ -0,0 +1,338 @@
+#include "catch.hpp"
+
+#include "utilz/flat-set.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace utilz;
+
+TEST_CASE("FlatSet Default Constructor Creates Empty Container", "[defaultConstructor]")
+{
+    const FlatSet<int> set;
+
+    CHECK(set.empty());
+    CHECK(set.size() == 0);
+    CHECK(set.isSorted());
+    CHECK(set.exists(0) == false);
+    CHECK(set.find(0) == std::end(set));
+    CHECK(std::begin(set) == std::end(set));
+}
+
+TEST_CASE("FlatSet insert/erase/exists", "[insert/erase/exists]")
+{
+    FlatSet<std::string> set;
+
+    CHECK(set.insert("b").second);
+    CHECK(set.insert("c").second);
+    CHECK(set.insert("a").second);
+    CHECK(set.insert("b").second == false);
+    CHECK(*set.insert("b").first == "b");
+
+    REQUIRE(set.size() == 3);
+    CHECK(set.isSorted());
+    CHECK(std::is_sorted(std::begin(set), std::end(set)));
+    CHECK(set.exists("a"));
+    CHECK(set.exists("d") == false);
+
+    CHECK(set.erase("b") == 1);
+    CHECK(set.erase("b") == 0);
+    CHECK(set.size() == 2);
+
+    set.erase(set.find("a"));
+    CHECK(set.size() == 1);
+    CHECK(*std::begin(set) == "c");
+
+    set.clear();
+    CHECK(set.empty());
+}
+
+TEST_CASE("FlatSet append/sortAndUnique", "[append/sortAndUnique]")
+{
+    FlatSet<int> set;
+
+    // appending in order keeps it sorted
+    set.append(1);
+    set.append(2);
+    CHECK(set.isSorted());
+
+    set.append(0);
+    set.append(2);
+    CHECK(set.isSorted() == false);
+    CHECK(set.size() == 4);
+    CHECK(set.exists(0));
+    CHECK(set.exists(3) == false);
+
+    // inserts into an unsorted set are still unique
+    CHECK(set.insert(0).second == false);
+    CHECK(set.insert(5).second);
+
+    set.sortAndUnique();
+    CHECK(set.isSorted());
+    CHECK(std::vector<int>(std::begin(set), std::end(set)) == std::vector<int>{ 0, 1, 2, 5 });
+
+    const std::vector<int> more{ 9, 1, 7, 7 };
+    set.insertRange(std::begin(more), std::end(more));
+    CHECK(
+        std::vector<int>(std::begin(set), std::end(set)) == std::vector<int>{ 0, 1, 2, 5, 7, 9 });
+}
+
+TEST_CASE("FlatSet set algebra", "[unionWith/intersectWith/difference]")
+{
+    std::mt19937 engine(2022);
+    std::uniform_int_distribution<int> keys(0, 1000);
+
+    for (int round(0); round < 20; ++round)
+    {
+        FlatSet<int> left;
+        FlatSet<int> right;
+        std::set<int> leftExpected;
+        std::set<int> rightExpected;
+
+        for (int i(0); i < 300; ++i)
+        {
+            const int leftKey{ keys(engine) };
+            const int rightKey{ keys(engine) };
+
+            // half the rounds merge with a set that was never sorted
+            if (0 == (round % 2))
+            {
+                left.insert(leftKey);
+                right.insert(rightKey);
+            }
+            else
+            {
+                left.append(leftKey);
+                right.append(rightKey);
+            }
+
+            leftExpected.insert(leftKey);
+            rightExpected.insert(rightKey);
+        }
+
+        std::vector<int> expected;
+
+        FlatSet<int> unionSet{ left };
+        unionSet.unionWith(right);
+        std::set_union(
+            std::begin(leftExpected),
+            std::end(leftExpected),
+            std::begin(rightExpected),
+            std::end(rightExpected),
+            std::back_inserter(expected));
+
+        REQUIRE(std::vector<int>(std::begin(unionSet), std::end(unionSet)) == expected);
+
+        expected.clear();
+        FlatSet<int> intersectSet{ left };
+        intersectSet.intersectWith(right);
+        std::set_intersection(
+            std::begin(leftExpected),
+            std::end(leftExpected),
+            std::begin(rightExpected),
+            std::end(rightExpected),
+            std::back_inserter(expected));
+
+        REQUIRE(std::vector<int>(std::begin(intersectSet), std::end(intersectSet)) == expected);
+
+        expected.clear();
+        FlatSet<int> differenceSet{ left };
+        differenceSet.difference(right);
+        std::set_difference(
+            std::begin(leftExpected),
+            std::end(leftExpected),
+            std::begin(rightExpected),
+            std::end(rightExpected),
+            std::back_inserter(expected));
+
+        REQUIRE(std::vector<int>(std::begin(differenceSet), std::end(differenceSet)) == expected);
+    }
+
+    FlatSet<int> set;
+    set.insert(1);
+    set.insert(2);
+
+    set.unionWith(set);
+    CHECK(set.size() == 2);
+
+    set.intersectWith(set);
+    CHECK(set.size() == 2);
+
+    set.difference(set);
+    CHECK(set.empty());
+}
+
+TEST_CASE("FlatSet compares", "[compares]")
+{
+    FlatSet<int> left;
+    left.append(3);
+    left.append(1);
+    left.append(3);
+
+    FlatSet<int> right;
+    right.insert(1);
+    right.insert(3);
+
+    // the order and duplicates from append() do not matter
+    CHECK(left == right);
+
+    right.insert(2);
+    CHECK(left != right);
+}
+
+TEST_CASE("SmallFlatSet and pmr::FlatSet", "[smallFlatSet/pmr]")
+{
+    SmallFlatSet<int, 4> small;
+    small.insert(3);
+    small.insert(1);
+    CHECK(small.size() == 2);
+    CHECK(small.exists(3));
+
+    FlatSet<int> big;
+    for (int i(0); i < 100; ++i)
+    {
+        big.insert(i);
+    }
+
+    // sets with different storage can still be merged
+    small.unionWith(big);
+    CHECK(small.size() == 100);
+    small.intersectWith(FlatSet<int>());
+    CHECK(small.empty());
+
+    std::pmr::monotonic_buffer_resource arena;
+    pmr::FlatSet<int> set(&arena);
+    set.insert(2);
+    set.insert(1);
+    CHECK(set.size() == 2);
+    CHECK(*std::begin(set) == 1);
+}
+
+TEST_CASE("HashedFlatSet insert/erase/exists", "[hashedFlatSet]")
+{
+    HashedFlatSet<std::string> set;
+
+    CHECK(set.empty());
+    CHECK(set.exists("") == false);
+
+    CHECK(set.insert("b").second);
+    CHECK(set.insert("a").second);
+    CHECK(set.insert("c").second);
+    CHECK(set.insert("a").second == false);
+    CHECK(set.size() == 3);
+
+    // insertion order is kept
+    CHECK(std::vector<std::string>(std::begin(set), std::end(set)) ==
+          std::vector<std::string>{ "b", "a", "c" });
+
+    CHECK(set.erase("a") == 1);
+    CHECK(set.erase("a") == 0);
+    CHECK(set.exists("a") == false);
+    CHECK(*set.find("c") == "c");
+
+    set.erase(std::begin(set));
+    CHECK(set.size() == 1);
+    CHECK(set.exists("b") == false);
+    CHECK(set.exists("c"));
+
+    set.clear();
+    CHECK(set.empty());
+    CHECK(set.insert("c").second);
+}
+
+TEST_CASE("HashedFlatSet set algebra", "[hashedFlatSet]")
+{
+    std::mt19937 engine(2023);
+    std::uniform_int_distribution<int> keys(0, 1000);
+
+    HashedFlatSet<int> left;
+    HashedFlatSet<int> right;
+    std::set<int> leftExpected;
+    std::set<int> rightExpected;
+
+    for (int i(0); i < 300; ++i)
+    {
+        const int leftKey{ keys(engine) };
+        const int rightKey{ keys(engine) };
+
+        left.insert(leftKey);
+        right.insert(rightKey);
+        leftExpected.insert(leftKey);
+        rightExpected.insert(rightKey);
+    }
+
+    // the results keep the order of the left set, so they are compared as sets
+    const auto sorted = [](const HashedFlatSet<int> & set) {
+        std::vector<int> result(std::begin(set), std::end(set));
+        std::sort(std::begin(result), std::end(result));
+        return result;
+    };
+
+    std::vector<int> expected;
+
+    HashedFlatSet<int> unionSet{ left };
+    unionSet.unionWith(right);
+    std::set_union(
+        std::begin(leftExpected),
+        std::end(leftExpected),
+        std::begin(rightExpected),
+        std::end(rightExpected),
+        std::back_inserter(expected));
+
+    REQUIRE(sorted(unionSet) == expected);
+    CHECK(*std::begin(unionSet) == *std::begin(left));
+
+    expected.clear();
+    HashedFlatSet<int> intersectSet{ left };
+    intersectSet.intersectWith(right);
+    std::set_intersection(
+        std::begin(leftExpected),
+        std::end(leftExpected),
+        std::begin(rightExpected),
+        std::end(rightExpected),
+        std::back_inserter(expected));
+
+    REQUIRE(sorted(intersectSet) == expected);
+
+    for (const int key : expected)
+    {
+        REQUIRE(intersectSet.exists(key));
+    }
+
+    expected.clear();
+    HashedFlatSet<int> differenceSet{ left };
+    differenceSet.difference(right);
+    std::set_difference(
+        std::begin(leftExpected),
+        std::end(leftExpected),
+        std::begin(rightExpected),
+        std::end(rightExpected),
+        std::back_inserter(expected));
+
+    REQUIRE(sorted(differenceSet) == expected);
+    CHECK(differenceSet.exists(*std::begin(rightExpected)) == false);
+
+    HashedFlatSet<int> reversed;
+    for (auto iter(std::rbegin(left)); iter != std::rend(left); ++iter)
+    {
+        reversed.insert(*iter);
+    }
+
+    // compared as sets
+    CHECK(reversed == left);
+    reversed.erase(*std::begin(left));
+    CHECK(reversed != left);
+
+    left.unionWith(left);
+    CHECK(left.size() == leftExpected.size());
+
+    left.intersectWith(left);
+    CHECK(left.size() == leftExpected.size());
+
+    left.difference(left);
+    CHECK(left.empty());
+}
@@ -0,0 +1,82 @@
+#include "catch.hpp"
+
+#include "utilz/frozen-flat-map.hpp"
+
+#include <map>
+#include <random>
+#include <string>
+
+using namespace utilz;
+
+TEST_CASE("FrozenFlatMap Default Constructor Creates Empty Container", "[defaultConstructor]")
+{
+    FrozenFlatMap<std::string, std::string> map;
+
+    CHECK(map.empty());
+    CHECK(map.size() == 0);
+    CHECK(map.exists("") == false);
+    CHECK(map.indexOf("") == 0);
+    CHECK_THROWS(map.at(""));
+}
+
+TEST_CASE("FrozenFlatMap finds every key at every size", "[sizes]")
+{
+    // all the tree shapes, full and not
+    for (int size(0); size < 70; ++size)
+    {
+        FlatMap<int, int> map;
+        for (int i(size - 1); i >= 0; --i)
+        {
+            map.append((i * 2), i);
+        }
+
+        const auto frozen{ freeze(map) };
+        REQUIRE(frozen.size() == static_cast<std::size_t>(size));
+
+        for (int key(-1); key <= (size * 2); ++key)
+        {
+            const bool isKey{ ((key % 2) == 0) && (key >= 0) && (key < (size * 2)) };
+            REQUIRE(frozen.exists(key) == isKey);
+
+            if (isKey)
+            {
+                REQUIRE(frozen.at(key) == (key / 2));
+
+                const std::size_t index{ frozen.indexOf(key) };
+                REQUIRE(frozen.keys()[index] == key);
+                REQUIRE(frozen.values()[index] == (key / 2));
+            }
+        }
+    }
+}
+
+TEST_CASE("FrozenFlatMap duplicates, tombstones, and strings", "[duplicates]")
+{
+    std::mt19937 engine(789);
+
+    FlatMap<std::string, int> map;
+    std::map<std::string, int> expected;
+
+    for (int i(0); i < 5000; ++i)
+    {
+        const int number{ std::uniform_int_distribution<int>(0, 3000)(engine) };
+        const std::string key{ std::to_string(number) };
+        map.append(key, i);
+        expected.emplace(key, i);
+    }
+
+    map.markErased("42");
+    expected.erase("42");
+
+    const auto frozen{ freeze(std::move(map)) };
+    REQUIRE(frozen.size() == expected.size());
+    CHECK(frozen.exists("42") == false);
+
+    for (const auto & [key, data] : expected)
+    {
+        REQUIRE(frozen.at(key) == data); // the first one wins
+    }
+
+    CHECK(frozen.exists("3001") == false);
+    CHECK(frozen.exists("") == false);
+}
@@ -0,0 +1,59 @@
+#include "catch.hpp"
+
+#include "utilz/hash-mix.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace utilz;
+
+namespace
+{
+    // how full the fullest and emptiest of bucketCount buckets are compared to a perfect spread,
+    // when bucketOf(mixHash(key)) picks the bucket of every key = (i * stride)
+    template <typename BucketOf_t>
+    std::pair<double, double> occupancy(
+        const std::uint64_t stride, const std::size_t bucketCount, BucketOf_t bucketOf)
+    {
+        const std::size_t keyCount{ bucketCount * 1000 };
+        std::vector<std::size_t> counts(bucketCount, 0);
+
+        for (std::uint64_t i(0); i < keyCount; ++i)
+        {
+            ++counts[bucketOf(mixHash(i * stride)) % bucketCount];
+        }
+
+        const auto [fewest, most] = std::minmax_element(std::begin(counts), std::end(counts));
+        const double expected{ static_cast<double>(keyCount / bucketCount) };
+        return { (static_cast<double>(*fewest) / expected),
+                 (static_cast<double>(*most) / expected) };
+    }
+} // namespace
+
+TEST_CASE("mixHash spreads identity hashes across buckets", "[mixHash]")
+{
+    static_assert(mixHash(0) == 0);
+
+    // std::hash of integers is usually the number, and keys are often sequential or multiples
+    // of some stride, which without mixing would all land in the same few buckets
+    for (const std::uint64_t stride : { 1ull, 2ull, 16ull, 64ull, 4096ull, (1ull << 32) })
+    {
+        INFO("stride " << stride);
+
+        // the low bits, like the control bytes and groups of HashedFlatMap
+        const auto [lowFewest, lowMost] =
+            occupancy(stride, 128, [](const std::uint64_t hash) { return hash & 0x7F; });
+
+        CHECK(lowFewest > 0.8);
+        CHECK(lowMost < 1.2);
+
+        // the high bits, like the shards of ShardedFlatMap
+        const auto [highFewest, highMost] =
+            occupancy(stride, 16, [](const std::uint64_t hash) { return (hash >> 32); });
+
+        CHECK(highFewest > 0.8);
+        CHECK(highMost < 1.2);
+    }
+}
@@ -0,0 +1,214 @@
+#include "catch.hpp"
+
+#include "utilz/hashed-flat-map.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace utilz;
+
+TEST_CASE("HashedFlatMap Default Constructor Creates Empty Container", "[defaultConstructor]")
+{
+    HashedFlatMap<std::string, std::string> map;
+
+    CHECK(map.empty());
+    CHECK(map.size() == 0);
+    CHECK(map.exists("") == false);
+    CHECK_THROWS(map.at(""));
+}
+
+TEST_CASE("HashedFlatMap append/at keeps insertion order", "[append/at]")
+{
+    HashedFlatMap<int, int> map;
+
+    // enough to grow the index many times
+    for (int i(0); i < 50'000; ++i)
+    {
+        map.append((i * 7), i);
+    }
+
+    CHECK(map.size() == 50'000);
+
+    for (int i(0); i < 50'000; ++i)
+    {
+        REQUIRE(map.at(i * 7) == i);
+    }
+
+    REQUIRE_THROWS(map.at(1));
+    REQUIRE(map.find(1) == std::end(map));
+    REQUIRE(map.exists(-7) == false);
+
+    int expected{ 0 };
+    for (const auto & pair : map)
+    {
+        REQUIRE(pair.second == expected++);
+    }
+}
+
+TEST_CASE("HashedFlatMap operator[] and duplicates", "[indexOperator/duplicates]")
+{
+    HashedFlatMap<std::string, int> map;
+
+    CHECK(map["zero"] == 0);
+    map["one"] = 1;
+    map["two"] = 2;
+    CHECK(map.size() == 3);
+    CHECK(map["two"] == 2);
+    CHECK(map.size() == 3);
+
+    // only the first duplicate is found
+    map.append("one", 100);
+    CHECK(map.size() == 4);
+    CHECK(map.at("one") == 1);
+
+    map.erase("one");
+    CHECK(map.size() == 2);
+    CHECK(map.exists("one") == false);
+    CHECK(map.at("two") == 2);
+}
+
+TEST_CASE("HashedFlatMap erase/clear/reserve", "[erase/clear/reserve]")
+{
+    HashedFlatMap<int, std::string> map;
+
+    map.reserve(1000);
+    CHECK(map.capacity() >= 1000);
+
+    for (int i(0); i < 1000; ++i)
+    {
+        map.append(i, std::to_string(i));
+    }
+
+    map.erase(std::begin(map), std::begin(map) + 500);
+    CHECK(map.size() == 500);
+    CHECK(map.exists(499) == false);
+    CHECK(map.at(500) == "500");
+
+    map.erase(map.find(999));
+    CHECK(map.size() == 499);
+    CHECK(map.exists(999) == false);
+    CHECK(map.at(998) == "998");
+
+    map.shrinkToFit();
+    CHECK(map.at(998) == "998");
+
+    map.clear();
+    CHECK(map.empty());
+    CHECK(map.exists(500) == false);
+
+    map[5] = "five";
+    CHECK(map.at(5) == "five");
+}
+
+TEST_CASE("HashedFlatMap sortAndUnique/compares", "[sortAndUnique/compares]")
+{
+    HashedFlatMap<int, int> map1;
+
+    map1.append(4, 0);
+    map1.append(3, 0);
+    map1.append(3, 0);
+    map1.append(1, 0);
+    map1.append(0, 0);
+    map1.append(2, 0);
+
+    HashedFlatMap<int, int> map2;
+
+    for (int i(0); i < 5; ++i)
+    {
+        map2.append(i, 0);
+    }
+
+    CHECK(map1 != map2);
+
+    map1.sortAndUnique();
+
+    CHECK(std::is_sorted(std::begin(map1), std::end(map1)));
+    CHECK(map1 == map2);
+    CHECK(map1 <= map2);
+
+    map2[2] = 1;
+    CHECK(map1 != map2);
+    CHECK(map1 < map2);
+    CHECK(map2 > map1);
+}
+
+TEST_CASE("HashedFlatMap sortAndUnique keeps the first appended", "[sortAndUnique]")
+{
+    // later duplicates have smaller data, so sorting whole pairs would keep the wrong ones
+    HashedFlatMap<int, int> map;
+    map.append(2, 20);
+    map.append(1, 10);
+    map.append(2, 5);
+    map.append(1, 1);
+    map.append(2, 0);
+
+    CHECK(map.at(1) == 10);
+    CHECK(map.at(2) == 20);
+
+    map.sortAndUnique();
+
+    REQUIRE(map.size() == 2);
+    CHECK(std::begin(map)->first == 1);
+    CHECK(map.at(1) == 10);
+    CHECK(map.at(2) == 20);
+
+    // the data doesn't need operator<
+    struct Unordered
+    {
+        int value;
+    };
+
+    HashedFlatMap<int, Unordered> unordered;
+    unordered.append(1, Unordered{ 1 });
+    unordered.append(0, Unordered{ 0 });
+    unordered.append(1, Unordered{ 2 });
+    unordered.sortAndUnique();
+
+    REQUIRE(unordered.size() == 2);
+    CHECK(unordered.at(0).value == 0);
+    CHECK(unordered.at(1).value == 1);
+}
+
+TEST_CASE("HashedFlatMap findMany/atMany", "[findMany/atMany]")
+{
+    HashedFlatMap<int, int> map;
+
+    std::vector<int> keys;
+    std::vector<HashedFlatMap<int, int>::iterator_t> found;
+    map.findMany(std::begin(keys), std::end(keys), std::back_inserter(found));
+    CHECK(found.empty());
+
+    keys.push_back(1);
+    map.findMany(std::begin(keys), std::end(keys), std::back_inserter(found));
+    CHECK(found.front() == std::end(map));
+
+    for (int i(0); i < 1000; ++i)
+    {
+        map.append((i * 3), i);
+    }
+
+    keys.clear();
+    for (int i(0); i < 100; ++i)
+    {
+        keys.push_back(i);
+    }
+
+    found.clear();
+    map.findMany(std::begin(keys), std::end(keys), std::back_inserter(found));
+    REQUIRE(found.size() == keys.size());
+
+    for (std::size_t i(0); i < keys.size(); ++i)
+    {
+        REQUIRE(found[i] == map.find(keys[i]));
+    }
+
+    const std::vector<int> existing{ 9, 0, 2997 };
+    std::vector<int> values;
+    map.atMany(std::begin(existing), std::end(existing), std::back_inserter(values));
+    CHECK(values == std::vector<int>{ 3, 0, 999 });
+
+    CHECK_THROWS(map.atMany(std::begin(keys), std::end(keys), std::back_inserter(values)));
+    CHECK(values.size() == 3);
+}
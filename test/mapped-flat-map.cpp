@@ -0,0 +1,152 @@
+#include "catch.hpp"
+
+#include "utilz/mapped-flat-map.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <random>
+#include <string>
+
+using namespace utilz;
+
+namespace
+{
+    struct Point
+    {
+        double x;
+        double y;
+    };
+
+    // removes the file when the test is done, even if it failed
+    struct TempFile
+    {
+        explicit TempFile(const std::string & name)
+            : path((std::filesystem::temp_directory_path() / name).string())
+        {}
+
+        ~TempFile() { std::remove(path.c_str()); }
+
+        std::string path;
+    };
+} // namespace
+
+TEST_CASE("MappedFlatMap Default Constructor Creates Empty Container", "[defaultConstructor]")
+{
+    MappedFlatMap<int, int> map;
+
+    CHECK(map.empty());
+    CHECK(map.size() == 0);
+    CHECK(map.exists(0) == false);
+    CHECK_THROWS(map.at(0));
+}
+
+TEST_CASE("MappedFlatMap save/open round trip", "[save/open]")
+{
+    const TempFile file("utilz-mapped-flat-map-test.bin");
+
+    std::mt19937 engine(1011);
+    FlatMap<std::uint32_t, Point> map;
+    std::map<std::uint32_t, double> expected;
+
+    for (int i(0); i < 10'000; ++i)
+    {
+        const std::uint32_t key{ std::uniform_int_distribution<std::uint32_t>(0, 5000)(engine) };
+        map.append(key, Point{ static_cast<double>(i), 0.5 });
+        expected.emplace(key, static_cast<double>(i));
+    }
+
+    map.markErased(map.begin()->first);
+    expected.erase(map.begin()->first);
+
+    save(map, file.path);
+
+    auto mapped{ MappedFlatMap<std::uint32_t, Point>::open(file.path) };
+    REQUIRE(mapped.size() == expected.size());
+    CHECK(std::is_sorted(mapped.keys(), (mapped.keys() + mapped.size())));
+    CHECK(mapped.exists(map.begin()->first) == false);
+    CHECK(mapped.exists(5001) == false);
+
+    for (const auto & [key, x] : expected)
+    {
+        const Point & point{ mapped.at(key) };
+        REQUIRE(point.x == x); // the first one wins
+        REQUIRE(point.y == 0.5);
+    }
+
+    // a map moved from keeps working since the mapping moves with it
+    MappedFlatMap<std::uint32_t, Point> moved{ std::move(mapped) };
+    CHECK(moved.size() == expected.size());
+    CHECK(moved.exists(expected.begin()->first));
+    CHECK(mapped.empty());
+    CHECK(mapped.keys() == nullptr);
+    CHECK(mapped.exists(expected.begin()->first) == false);
+
+    // assigning over a map releases its old mapping
+    moved = MappedFlatMap<std::uint32_t, Point>::open(file.path);
+    CHECK(moved.size() == expected.size());
+    mapped = std::move(moved);
+    CHECK(mapped.size() == expected.size());
+    CHECK(moved.empty());
+}
+
+TEST_CASE("MappedFlatMap empty maps and bad files", "[errors]")
+{
+    const TempFile file("utilz-mapped-flat-map-errors.bin");
+
+    save(FlatMap<int, char>(), file.path);
+    const auto empty{ MappedFlatMap<int, char>::open(file.path) };
+    CHECK(empty.empty());
+    CHECK(empty.exists(0) == false);
+
+    // the sizes of the key and data are checked
+    CHECK_THROWS(MappedFlatMap<std::int64_t, char>::open(file.path));
+    CHECK_THROWS(MappedFlatMap<int, int>::open(file.path));
+
+    FlatMap<int, int> map;
+    map.append(1, 2);
+    save(map, file.path);
+    CHECK(MappedFlatMap<int, int>::open(file.path).at(1) == 2);
+
+    // a header that claims more than the file holds, with values picked to overflow
+    const auto openWithHeaderField = [&](const std::size_t offset, const std::uint64_t value) {
+        save(map, file.path);
+        {
+            std::fstream image(file.path, (std::ios::in | std::ios::out | std::ios::binary));
+            image.seekp(static_cast<std::streamoff>(offset));
+            image.write(reinterpret_cast<const char *>(&value), sizeof(value));
+        }
+
+        return MappedFlatMap<int, int>::open(file.path);
+    };
+
+    CHECK(openWithHeaderField(offsetof(FlatMapImageHeader, count), 1).at(1) == 2);
+
+    const std::uint64_t huge{ ~std::uint64_t(0) };
+    const std::uint64_t wrapsAround{ (huge / sizeof(int)) + 2 };
+    CHECK_THROWS(openWithHeaderField(offsetof(FlatMapImageHeader, count), 2));
+    CHECK_THROWS(openWithHeaderField(offsetof(FlatMapImageHeader, count), huge));
+    CHECK_THROWS(openWithHeaderField(offsetof(FlatMapImageHeader, count), wrapsAround));
+    CHECK_THROWS(openWithHeaderField(offsetof(FlatMapImageHeader, keysOffset), (huge - 63)));
+    CHECK_THROWS(openWithHeaderField(offsetof(FlatMapImageHeader, valuesOffset), (huge - 63)));
+
+    save(map, file.path);
+    std::filesystem::resize_file(file.path, (std::filesystem::file_size(file.path) - 1));
+    CHECK_THROWS(MappedFlatMap<int, int>::open(file.path));
+
+    {
+        std::ofstream text(file.path, std::ios::trunc);
+        text << "key=value\n";
+    }
+
+    CHECK_THROWS(MappedFlatMap<int, int>::open(file.path));
+
+    std::filesystem::resize_file(file.path, 0);
+    CHECK_THROWS(MappedFlatMap<int, int>::open(file.path));
+
+    CHECK_THROWS(MappedFlatMap<int, int>::open(file.path + ".does-not-exist"));
+}
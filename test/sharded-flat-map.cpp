@@ -0,0 +1,107 @@
+#include "catch.hpp"
+
+#include "utilz/sharded-flat-map.hpp"
+
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+using namespace utilz;
+
+TEST_CASE("ShardedFlatMap Default Constructor Creates Empty Container", "[defaultConstructor]")
+{
+    ShardedFlatMap<std::string, std::string> map;
+
+    CHECK(map.empty());
+    CHECK(map.size() == 0);
+    CHECK(map.find("") == std::nullopt);
+    CHECK(map.snapshot().empty());
+}
+
+TEST_CASE("ShardedFlatMap insert/find/erase", "[insert/find/erase]")
+{
+    ShardedFlatMap<int, std::string, 4> map;
+
+    for (int i(0); i < 100; ++i)
+    {
+        REQUIRE(map.insert(i, std::to_string(i)));
+    }
+
+    CHECK(map.insert(5, "five") == false);
+    CHECK(map.find(5) == "5");
+
+    map.insertOrAssign(5, "five");
+    CHECK(map.find(5) == "five");
+    CHECK(map.size() == 100);
+
+    map.erase(5);
+    map.erase(1000);
+    CHECK(map.exists(5) == false);
+    CHECK(map.size() == 99);
+
+    CHECK(map.update(7, [](std::string & data) { return data.size(); }) == 1);
+    map.update(200, [](std::string & data) { data = "new"; });
+    CHECK(map.find(200) == "new");
+
+    // references are returned as copies so that nothing escapes the lock
+    const auto byReference{ [](std::string & data) -> std::string & { return data; } };
+    static_assert(std::is_same_v<decltype(map.update(200, byReference)), std::string>);
+    CHECK(map.update(200, byReference) == "new");
+
+    std::size_t count{ 0 };
+    map.forEach([&](const int, std::string & data) {
+        data += "!";
+        ++count;
+    });
+
+    CHECK(count == 100);
+    CHECK(map.find(0) == "0!");
+
+    auto snapshot{ map.snapshot() };
+    CHECK(snapshot.size() == 100);
+    snapshot.sortAndUnique();
+    CHECK(snapshot.begin()->first == 0);
+    CHECK(snapshot.rbegin()->first == 200);
+
+    map.clear();
+    CHECK(map.empty());
+}
+
+TEST_CASE("ShardedFlatMap many threads updating counters", "[threads]")
+{
+    ShardedFlatMap<int, int> map;
+
+    const int threadCount{ 8 };
+    const int keyCount{ 50 };
+    const int repeatCount{ 200 };
+
+    std::vector<std::thread> threads;
+    for (int t(0); t < threadCount; ++t)
+    {
+        threads.emplace_back([&]() {
+            for (int r(0); r < repeatCount; ++r)
+            {
+                for (int key(0); key < keyCount; ++key)
+                {
+                    map.update(key, [](int & counter) { ++counter; });
+                }
+            }
+        });
+    }
+
+    const auto during{ map.snapshot() };
+    CHECK(during.size() <= static_cast<std::size_t>(keyCount));
+
+    for (std::thread & thread : threads)
+    {
+        thread.join();
+    }
+
+    CHECK(map.size() == static_cast<std::size_t>(keyCount));
+
+    const ShardedFlatMap<int, int> & constMap{ map };
+    constMap.forEach(
+        [&](const int, const int counter) { REQUIRE(counter == (threadCount * repeatCount)); });
+}
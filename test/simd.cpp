@@ -0,0 +1,86 @@
+#include "catch.hpp"
+
+#include "utilz/simd.hpp"
+
+#include <cstdint>
+#include <vector>
+
+using namespace utilz;
+
+namespace
+{
+    enum class Color : std::uint16_t
+    {
+        Red,
+        Green,
+        Blue
+    };
+
+    // checks every position in every length up to a few registers, plus not found
+    template <typename T>
+    void checkFindEqualAllPositions()
+    {
+        for (std::size_t count(0); count < 80; ++count)
+        {
+            std::vector<T> numbers;
+
+            for (std::size_t i(0); i < count; ++i)
+            {
+                numbers.push_back(static_cast<T>(static_cast<T>(i) - static_cast<T>(40)));
+            }
+
+            for (std::size_t i(0); i < count; ++i)
+            {
+                REQUIRE(simd::findEqual(numbers.data(), count, numbers[i]) == i);
+            }
+
+            REQUIRE(simd::findEqual(numbers.data(), count, static_cast<T>(100)) == count);
+        }
+    }
+} // namespace
+
+TEST_CASE("isScannable", "[isScannable]")
+{
+    CHECK(simd::isScannable<char>);
+    CHECK(simd::isScannable<int>);
+    CHECK(simd::isScannable<std::uint64_t>);
+    CHECK(simd::isScannable<Color>);
+    CHECK(simd::isScannable<float> == false);
+    CHECK(simd::isScannable<int *> == false);
+}
+
+TEST_CASE("findEqual finds the first match for every size", "[findEqual]")
+{
+    checkFindEqualAllPositions<std::int8_t>();
+    checkFindEqualAllPositions<std::int16_t>();
+    checkFindEqualAllPositions<std::int32_t>();
+    checkFindEqualAllPositions<std::int64_t>();
+    checkFindEqualAllPositions<std::uint64_t>();
+}
+
+TEST_CASE("findEqual returns the first of duplicates", "[findEqualDuplicates]")
+{
+    // only the low or high 32 bits matching must not count as a 64 bit match
+    const std::vector<std::uint64_t> numbers{ 0x1'0000'0005, 0x5'0000'0001, 5, 5, 5 };
+
+    CHECK(simd::findEqual(numbers.data(), numbers.size(), std::uint64_t(5)) == 2);
+    CHECK(simd::findEqual(numbers.data(), numbers.size(), std::uint64_t(0)) == numbers.size());
+
+    const std::vector<Color> colors(40, Color::Red);
+    CHECK(simd::findEqual(colors.data(), colors.size(), Color::Red) == 0);
+    CHECK(simd::findEqual(colors.data(), colors.size(), Color::Blue) == colors.size());
+    CHECK(simd::findEqual(colors.data(), 0, Color::Red) == 0);
+}
+
+TEST_CASE("matchBytes16 sets one bit per matching byte", "[matchBytes16]")
+{
+    std::int8_t group[16] = { 0 };
+    group[0] = 5;
+    group[7] = 5;
+    group[15] = -128;
+
+    CHECK(simd::matchBytes16(group, 5) == ((1u << 0) | (1u << 7)));
+    CHECK(simd::matchBytes16(group, -128) == (1u << 15));
+    CHECK(simd::matchBytes16(group, 1) == 0);
+    CHECK(simd::countTrailingZeros(simd::matchBytes16(group, 0)) == 1);
+}
@@ -0,0 +1,99 @@
+#include "catch.hpp"
+
+#include "utilz/small-vector.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+
+using namespace utilz;
+
+TEST_CASE("SmallVector stays inline until full", "[inline]")
+{
+    SmallVector<std::string, 3> vec;
+
+    CHECK(vec.empty());
+    CHECK(vec.isInline());
+    CHECK(vec.capacity() == 3);
+    CHECK(vec.inlineCapacity() == 3);
+
+    vec.push_back("a");
+    vec.emplace_back("b");
+    vec.emplace_back(std::string(100, 'c'));
+
+    CHECK(vec.size() == 3);
+    CHECK(vec.isInline());
+
+    vec.emplace_back(vec.front()); // referring to an element while growing
+    CHECK(vec.isInline() == false);
+    CHECK(vec.size() == 4);
+    CHECK(vec.back() == "a");
+    CHECK(vec[2] == std::string(100, 'c'));
+
+    vec.pop_back();
+    vec.shrink_to_fit();
+    CHECK(vec.isInline());
+    CHECK(vec.size() == 3);
+    CHECK(vec.at(1) == "b");
+    CHECK_THROWS(vec.at(3));
+}
+
+TEST_CASE("SmallVector insert/erase", "[insert/erase]")
+{
+    SmallVector<int, 4> vec{ 0, 1, 2, 3 };
+
+    vec.insert((std::begin(vec) + 1), 10);
+    CHECK(vec == SmallVector<int, 4>{ 0, 10, 1, 2, 3 });
+
+    vec.emplace(std::begin(vec), -1);
+    vec.insert(std::end(vec), 4);
+    CHECK(vec == SmallVector<int, 4>{ -1, 0, 10, 1, 2, 3, 4 });
+
+    const auto iter{ vec.erase(std::begin(vec) + 2) };
+    CHECK(*iter == 1);
+    CHECK(vec == SmallVector<int, 4>{ -1, 0, 1, 2, 3, 4 });
+
+    vec.erase(std::begin(vec), std::begin(vec) + 2);
+    CHECK(vec == SmallVector<int, 4>{ 1, 2, 3, 4 });
+    CHECK(vec < SmallVector<int, 4>{ 1, 2, 4 });
+
+    vec.erase(std::begin(vec), std::end(vec));
+    CHECK(vec.empty());
+}
+
+TEST_CASE("SmallVector copy/move/swap", "[copy/move/swap]")
+{
+    SmallVector<std::unique_ptr<int>, 2> small;
+    small.push_back(std::make_unique<int>(1));
+
+    SmallVector<std::unique_ptr<int>, 2> big;
+    for (int i(0); i < 5; ++i)
+    {
+        big.push_back(std::make_unique<int>(i));
+    }
+
+    SmallVector<std::unique_ptr<int>, 2> moved{ std::move(small) };
+    CHECK(small.empty());
+    CHECK(moved.isInline());
+    CHECK(*moved[0] == 1);
+
+    moved = std::move(big);
+    CHECK(big.empty());
+    CHECK(big.isInline());
+    CHECK(moved.size() == 5);
+    CHECK(*moved[4] == 4);
+
+    SmallVector<std::string, 2> left{ "a" };
+    SmallVector<std::string, 2> right{ "b", "c", "d" };
+    swap(left, right);
+    CHECK(left.size() == 3);
+    CHECK(right.size() == 1);
+    CHECK(right[0] == "a");
+
+    left = right;
+    CHECK(left == right);
+    CHECK(left.isInline());
+
+    std::sort(std::begin(right), std::end(right));
+    CHECK(std::count(std::begin(right), std::end(right), "a") == 1);
+}
@@ -0,0 +1,173 @@
+#include "catch.hpp"
+
+#include "utilz/snapshot-flat-map.hpp"
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace utilz;
+
+TEST_CASE("SnapshotFlatMap Default Constructor Creates Empty Container", "[defaultConstructor]")
+{
+    SnapshotFlatMap<std::string, std::string> map;
+
+    CHECK(map.empty());
+    CHECK(map.size() == 0);
+    CHECK(map.find("") == std::nullopt);
+    CHECK(map.snapshot()->empty());
+}
+
+TEST_CASE("SnapshotFlatMap snapshots never change", "[snapshot/update/publish]")
+{
+    FlatMap<std::string, int> initial;
+    initial.append("a", 1);
+
+    SnapshotFlatMap<std::string, int> map(initial);
+    const auto before{ map.snapshot() };
+
+    map.insertOrAssign("b", 2);
+    map.insertOrAssign("a", 10);
+
+    CHECK(before->size() == 1);
+    CHECK(before->at("a") == 1);
+    CHECK(map.find("a") == 10);
+    CHECK(map.find("b") == 2);
+
+    // many changes with one copy and one publish
+    const auto during{ map.snapshot() };
+    const std::size_t sizeInside{ map.update([&](FlatMap<std::string, int> & next) {
+        next.erase("a");
+        next["c"] = 3;
+        next["d"] = 4;
+        return next.size();
+    }) };
+
+    CHECK(sizeInside == 3);
+    CHECK(during->size() == 2);
+    CHECK(map.size() == 3);
+    CHECK(map.exists("a") == false);
+
+    // a throwing update publishes nothing
+    CHECK_THROWS(map.update([](FlatMap<std::string, int> & next) {
+        next.clear();
+        throw std::runtime_error("failed");
+    }));
+
+    CHECK(map.size() == 3);
+
+    map.erase("c");
+    CHECK(map.size() == 2);
+
+    map.publish(initial);
+    CHECK(map.size() == 1);
+    CHECK(map.find("a") == 1);
+
+    map.clear();
+    CHECK(map.empty());
+}
+
+TEST_CASE("SnapshotFlatMap readers while writing", "[threads]")
+{
+    // two maps so that their loads and stores also contend on the shared_ptr atomics lock pool
+    SnapshotFlatMap<int, int> maps[2];
+    std::atomic<bool> isWriting{ true };
+    std::atomic<int> tornCount{ 0 };
+    std::atomic<int> backwardsCount{ 0 };
+
+    // Every published version n has keys 0 to n-1 all holding n, so a torn read would show.  A
+    // snapshot must hold each key once, match its own size(), and never be older than the last.
+    const auto isConsistent = [](const FlatMap<int, int> & snapshot) {
+        const int count{ static_cast<int>(snapshot.size()) };
+
+        int seen{ 0 };
+        long long keySum{ 0 };
+        for (const auto & pair : snapshot)
+        {
+            if ((pair.first < 0) || (pair.first >= count) || (pair.second != count))
+            {
+                return false;
+            }
+
+            ++seen;
+            keySum += pair.first;
+        }
+
+        return ((seen == count) && (keySum == ((static_cast<long long>(count) * (count - 1)) / 2)));
+    };
+
+    // Catch can't be used from other threads, so failures are counted and checked after
+    std::vector<std::thread> readers;
+    for (int t(0); t < 4; ++t)
+    {
+        readers.emplace_back([&]() {
+            std::size_t lastSize[2]{ 0, 0 };
+
+            while (isWriting)
+            {
+                for (int m(0); m < 2; ++m)
+                {
+                    const auto snapshot{ maps[m].snapshot() };
+
+                    if (!isConsistent(*snapshot))
+                    {
+                        ++tornCount;
+                    }
+
+                    if (snapshot->size() < lastSize[m])
+                    {
+                        ++backwardsCount;
+                    }
+
+                    lastSize[m] = snapshot->size();
+                }
+            }
+        });
+    }
+
+    // one map grows by update() and the other by building each version and publishing it
+    std::thread publisher([&]() {
+        FlatMap<int, int> next;
+        for (int version(1); version <= 200; ++version)
+        {
+            next[version - 1] = 0;
+            for (auto & pair : next)
+            {
+                pair.second = version;
+            }
+
+            maps[1].publish(next);
+        }
+    });
+
+    for (int version(1); version <= 200; ++version)
+    {
+        maps[0].update([&](FlatMap<int, int> & next) {
+            next[version - 1] = 0;
+
+            for (auto & pair : next)
+            {
+                pair.second = version;
+            }
+        });
+    }
+
+    publisher.join();
+    isWriting = false;
+    for (std::thread & reader : readers)
+    {
+        reader.join();
+    }
+
+    CHECK(tornCount == 0);
+    CHECK(backwardsCount == 0);
+
+    for (const SnapshotFlatMap<int, int> & map : maps)
+    {
+        CHECK(isConsistent(*map.snapshot()));
+        CHECK(map.size() == 200);
+        CHECK(map.find(0) == 200);
+    }
+}
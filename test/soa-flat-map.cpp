@@ -0,0 +1,194 @@
+#include "catch.hpp"
+
+#include "utilz/soa-flat-map.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string>
+
+using namespace utilz;
+
+TEST_CASE("SoaFlatMap Default Constructor Creates Empty Container", "[defaultConstructor]")
+{
+    SoaFlatMap<std::string, std::string> map;
+
+    CHECK(map.empty());
+    CHECK(map.size() == 0);
+    CHECK(map.begin() == map.end());
+    CHECK_THROWS(map.at(""));
+}
+
+TEST_CASE("SoaFlatMap append/at/operator[]", "[append/at/indexOperator]")
+{
+    SoaFlatMap<int, std::array<char, 200>> map;
+
+    for (int i(0); i < 10; ++i)
+    {
+        std::array<char, 200> data{};
+        data[0] = static_cast<char>(i);
+        map.append(i, data);
+    }
+
+    CHECK(map.size() == 10);
+    CHECK(map.keys().size() == 10);
+    CHECK(map.values().size() == 10);
+
+    for (int i(0); i < 10; ++i)
+    {
+        REQUIRE(map.at(i)[0] == static_cast<char>(i));
+        REQUIRE(map.exists(i));
+        REQUIRE(map.find(i)->first == i);
+    }
+
+    REQUIRE_THROWS(map.at(10));
+    REQUIRE(map.find(10) == std::end(map));
+
+    map[10][0] = 'x';
+    CHECK(map.size() == 11);
+    CHECK(map.at(10)[0] == 'x');
+}
+
+TEST_CASE("SoaFlatMap iterators yield key/value proxies", "[iterators]")
+{
+    SoaFlatMap<int, std::string> map;
+
+    for (int i(0); i < 5; ++i)
+    {
+        map.append(i, std::to_string(i));
+    }
+
+    int count{ 0 };
+    for (auto pair : map)
+    {
+        REQUIRE(pair.second == std::to_string(pair.first));
+        pair.second += "!";
+        ++count;
+    }
+
+    CHECK(count == 5);
+    CHECK(map.at(3) == "3!");
+    CHECK((std::end(map) - std::begin(map)) == 5);
+    CHECK((*map.rbegin()).first == 4);
+
+    const SoaFlatMap<int, std::string> & constMap{ map };
+    CHECK(std::count_if(std::begin(constMap), std::end(constMap), [](const auto & pair) {
+              return (pair.first > 1);
+          }) == 3);
+}
+
+TEST_CASE("SoaFlatMap erase", "[erase]")
+{
+    SoaFlatMap<int, std::string> map;
+
+    for (int i(0); i < 100; ++i)
+    {
+        map.append(i, std::to_string(i));
+    }
+
+    map.append(50, "duplicate");
+    map.erase(50);
+    CHECK(map.exists(50) == false);
+    CHECK(map.size() == 99);
+
+    const auto iter{ map.erase(std::begin(map), std::begin(map) + 10) };
+    CHECK(iter->first == 10);
+    CHECK(map.size() == 89);
+
+    map.erase(map.find(99));
+    CHECK(map.size() == 88);
+    CHECK(map.keys().size() == map.values().size());
+
+    map.erase(std::begin(map), std::end(map));
+    CHECK(map.empty());
+}
+
+TEST_CASE("SoaFlatMap sortAndUnique/compares", "[sortAndUnique/compares]")
+{
+    SoaFlatMap<int, int> map1;
+
+    map1.append(4, 0);
+    map1.append(3, 0);
+    map1.append(3, 1);
+    map1.append(1, 0);
+    map1.append(0, 0);
+    map1.append(2, 0);
+    map1.append(4, 1);
+
+    SoaFlatMap<int, int> map2;
+
+    for (int i(0); i < 5; ++i)
+    {
+        map2.append(i, 0);
+    }
+
+    CHECK(map1 != map2);
+
+    map1.sortAndUnique();
+
+    CHECK(std::is_sorted(std::begin(map1.keys()), std::end(map1.keys())));
+    CHECK(map1 == map2);
+    CHECK(map1 <= map2);
+
+    map2[5] = 0;
+    CHECK(map1 < map2);
+    CHECK(map2 > map1);
+}
+
+TEST_CASE("SoaFlatMap with integral keys", "[integralKeys]")
+{
+    SoaFlatMap<std::uint64_t, int> map;
+
+    for (int i(0); i < 1000; ++i)
+    {
+        map.append((static_cast<std::uint64_t>(i) << 32), i);
+    }
+
+    for (int i(0); i < 1000; ++i)
+    {
+        REQUIRE(map.at(static_cast<std::uint64_t>(i) << 32) == i);
+    }
+
+    CHECK(map.exists(1) == false);
+    CHECK(map.find(std::uint64_t(1) << 63) == std::end(map));
+}
+
+TEST_CASE("SoaFlatMap with bool keys and values", "[bool]")
+{
+    SoaFlatMap<std::string, bool> flags;
+    flags["visible"] = true;
+    flags["locked"] = false;
+    flags.append("hidden", true);
+
+    CHECK(flags.size() == 3);
+    CHECK(flags.at("visible"));
+    CHECK(flags.at("locked") == false);
+
+    flags.find("locked")->second = true;
+    CHECK(flags.at("locked"));
+
+    std::size_t trueCount{ 0 };
+    for (const auto & [name, isSet] : flags)
+    {
+        trueCount += (isSet ? 1u : 0u);
+    }
+
+    CHECK(trueCount == 3);
+
+    flags.erase("hidden");
+    flags.sortAndUnique();
+    CHECK(flags.size() == 2);
+    CHECK(flags.keys().front() == "locked");
+
+    SoaFlatMap<bool, int> byBool;
+    byBool[true] = 1;
+    byBool[false] = 0;
+    byBool.append(true, 2);
+    CHECK(byBool.at(true) == 1);
+    CHECK(byBool.find(false)->second == 0);
+
+    byBool.sortAndUnique();
+    CHECK(byBool.size() == 2);
+    CHECK(byBool.keys()[0] == false);
+    CHECK(byBool == byBool);
+}
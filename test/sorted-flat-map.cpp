@@ -0,0 +1,265 @@
+#include "catch.hpp"
+
+#include "utilz/sorted-flat-map.hpp"
+
+#include <algorithm>
+#include <string>
+
+using namespace utilz;
+
+namespace
+{
+    // counts how many are default constructed, and has no operator<
+    struct Counted
+    {
+        Counted()
+            : value(0)
+        {
+            ++defaultCount;
+        }
+
+        explicit Counted(const int newValue)
+            : value(newValue)
+        {}
+
+        friend bool operator==(const Counted & left, const Counted & right)
+        {
+            return (left.value == right.value);
+        }
+
+        int value;
+        static inline int defaultCount{ 0 };
+    };
+} // namespace
+
+TEST_CASE("SortedFlatMap Default Constructor Creates Empty Container", "[defaultConstructor]")
+{
+    SortedFlatMap<std::string, std::string> map;
+
+    CHECK(map.empty());
+    CHECK(map.size() == 0);
+    CHECK(map.isSorted());
+    CHECK_THROWS(map.at(""));
+}
+
+TEST_CASE("SortedFlatMap insert keeps order and unique keys", "[insert]")
+{
+    SortedFlatMap<int, int> map;
+
+    for (int i(9); i >= 0; --i)
+    {
+        REQUIRE(map.insert(i, (i * i)).second);
+    }
+
+    REQUIRE(map.insert(5, 0).second == false);
+    REQUIRE(map.at(5) == 25);
+
+    CHECK(map.size() == 10);
+    CHECK(map.isSorted());
+    CHECK(std::is_sorted(std::begin(map), std::end(map)));
+
+    for (int i(0); i < 10; ++i)
+    {
+        REQUIRE(map.at(i) == (i * i));
+        REQUIRE(map.exists(i));
+    }
+
+    REQUIRE_THROWS(map.at(10));
+    REQUIRE(map.find(10) == std::end(map));
+}
+
+TEST_CASE("SortedFlatMap operator[]", "[indexOperator]")
+{
+    SortedFlatMap<int, int> map;
+
+    CHECK(map[3] == 0);
+    map[1] = 1;
+    map[2] = 4;
+    map[0] = 0;
+
+    CHECK(map.size() == 4);
+    CHECK(map[2] == 4);
+    CHECK(map.size() == 4);
+    CHECK(std::is_sorted(std::begin(map), std::end(map)));
+
+    // data is only constructed when the key is missing, in the front or in the tail
+    SortedFlatMap<int, Counted> counted;
+    counted.insert(1, Counted(10));
+    counted.append(2, Counted(20));
+    Counted::defaultCount = 0;
+
+    CHECK(counted[1].value == 10);
+    CHECK(counted[2].value == 20);
+    CHECK(Counted::defaultCount == 0);
+
+    CHECK(counted[3].value == 0);
+    CHECK(Counted::defaultCount == 1);
+}
+
+TEST_CASE("SortedFlatMap append then sortAndUnique", "[append/sortAndUnique]")
+{
+    SortedFlatMap<int, int> map;
+
+    map.insert(2, 20);
+    map.append(4, 0);
+    map.append(3, 0);
+    map.append(2, 0);
+    map.append(4, 1);
+    map.append(0, 0);
+
+    CHECK(map.isSorted() == false);
+
+    // lookups still work with an unsorted tail
+    CHECK(map.at(2) == 20);
+    CHECK(map.at(4) == 0);
+    CHECK(map.exists(0));
+    CHECK(map.exists(1) == false);
+    CHECK(map.insert(3, 99).second == false);
+
+    map.sortAndUnique();
+
+    CHECK(map.isSorted());
+    CHECK(map.size() == 4);
+    CHECK(map.at(2) == 20); // the first one wins
+    CHECK(map.at(4) == 0);
+    CHECK(std::is_sorted(std::begin(map), std::end(map)));
+}
+
+TEST_CASE("SortedFlatMap erase", "[erase]")
+{
+    SortedFlatMap<int, std::string> map;
+
+    for (int i(0); i < 100; ++i)
+    {
+        map.insert(i, std::to_string(i));
+    }
+
+    map.append(50, "duplicate");
+    map.append(100, "100");
+
+    map.erase(50);
+    CHECK(map.exists(50) == false);
+    CHECK(map.size() == 100);
+
+    map.erase(std::begin(map), std::begin(map) + 10);
+    CHECK(map.size() == 90);
+    CHECK(map.exists(9) == false);
+    CHECK(map.exists(10));
+    CHECK(map.exists(100));
+
+    map.erase(map.find(100));
+    CHECK(map.isSorted());
+
+    map.erase(std::begin(map), std::end(map));
+    CHECK(map.empty());
+    CHECK(map.isSorted());
+}
+
+TEST_CASE("SortedFlatMap lowerBound/upperBound", "[lowerBound/upperBound]")
+{
+    SortedFlatMap<int, int> map;
+
+    for (int i(0); i < 10; i += 2)
+    {
+        map.insert(i, i);
+    }
+
+    CHECK(map.lowerBound(4)->first == 4);
+    CHECK(map.upperBound(4)->first == 6);
+    CHECK(map.lowerBound(5)->first == 6);
+    CHECK(map.lowerBound(100) == std::end(map));
+}
+
+TEST_CASE("SortedFlatMap compares", "[compares]")
+{
+    SortedFlatMap<int, int> map1;
+    SortedFlatMap<int, int> map2;
+
+    CHECK(map1 == map2);
+    CHECK((map1 < map2) == false);
+
+    for (int i(0); i < 5; ++i)
+    {
+        map1.insert(i, 0);
+        map2.append((4 - i), 0);
+    }
+
+    CHECK(map1 == map2);
+    CHECK(map1 <= map2);
+    CHECK(map1 >= map2);
+
+    map2.sortAndUnique();
+    map2[5] = 0;
+
+    CHECK(map1 != map2);
+    CHECK(map1 < map2);
+    CHECK(map2 > map1);
+
+    // compared by what lookups see, so duplicates in the tail that are never found don't count
+    map1[5] = 0;
+    map1.append(2, 99);
+    map1.append(6, 1);
+    map1.append(6, 2);
+    map2.append(6, 1);
+    CHECK(map1 == map2);
+    CHECK((map1 < map2) == false);
+
+    map2.append(7, 0);
+    CHECK(map1 != map2);
+    CHECK(map1 < map2);
+
+    // the data only needs operator== for these
+    SortedFlatMap<int, Counted> left;
+    SortedFlatMap<int, Counted> right;
+    for (int i(0); i < 100; ++i)
+    {
+        left.append(i, Counted(i));
+        right.append((99 - i), Counted(99 - i));
+    }
+
+    CHECK(left == right);
+    right.append(0, Counted(-1));
+    CHECK(left == right);
+    right.append(100, Counted(100));
+    CHECK(left != right);
+}
+
+TEST_CASE("SortedFlatMap tail limit merges appends", "[tailLimit]")
+{
+    SortedFlatMap<int, int> map(8);
+    CHECK(map.tailLimit() == 8);
+
+    for (int i(0); i < 8; ++i)
+    {
+        map.append((100 - i), i);
+    }
+
+    CHECK(map.tailSize() == 8);
+    CHECK(map.isSorted() == false);
+
+    map.append(100, 999); // a duplicate that will be dropped when merged
+    CHECK(map.tailSize() == 0);
+    CHECK(map.isSorted());
+    CHECK(map.size() == 8);
+    CHECK(map.at(100) == 0);
+
+    for (int i(0); i < 1000; ++i)
+    {
+        map.append(i, i);
+        REQUIRE(map.tailSize() <= 8);
+    }
+
+    CHECK(map.at(50) == 50);
+    CHECK(map.at(99) == 1); // the first one wins
+    CHECK(map.at(93) == 7);
+    CHECK(map.size() == 1000);
+
+    map.sortAndUnique();
+    CHECK(map.isSorted());
+    CHECK(std::is_sorted(std::begin(map), std::end(map)));
+
+    map.tailLimit(0);
+    map.append(-1, -1);
+    map.append(-2, -2);
+    CHECK(map.tailSize() == 2);
+}
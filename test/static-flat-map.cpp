@@ -0,0 +1,75 @@
+#include "catch.hpp"
+
+#include "utilz/static-flat-map.hpp"
+
+#include <algorithm>
+#include <string_view>
+
+using namespace utilz;
+
+namespace
+{
+    enum class Opcode
+    {
+        Load,
+        Store,
+        Jump,
+        Halt
+    };
+
+    constexpr auto opcodes{ makeStaticFlatMap<std::string_view, Opcode>(
+        { { "store", Opcode::Store },
+          { "load", Opcode::Load },
+          { "jump", Opcode::Jump },
+          { "halt", Opcode::Halt } }) };
+
+    // all of this is checked by the compiler
+    static_assert(opcodes.size() == 4);
+    static_assert(opcodes.at("jump") == Opcode::Jump);
+    static_assert(opcodes.exists("store"));
+    static_assert(!opcodes.exists("nop"));
+    static_assert(opcodes.indexOf("nop") == opcodes.size());
+    static_assert(opcodes.keys()[0] == "halt");
+} // namespace
+
+TEST_CASE("StaticFlatMap lookups", "[at/exists/indexOf]")
+{
+    CHECK(opcodes.at("load") == Opcode::Load);
+    CHECK(opcodes.at("halt") == Opcode::Halt);
+    CHECK_THROWS(opcodes.at("nop"));
+    CHECK(std::is_sorted(std::begin(opcodes.keys()), std::end(opcodes.keys())));
+
+    const std::size_t index{ opcodes.indexOf("store") };
+    REQUIRE(index < opcodes.size());
+    CHECK(opcodes.values()[index] == Opcode::Store);
+}
+
+TEST_CASE("StaticFlatMap every size finds every key", "[sizes]")
+{
+    constexpr auto map{ makeStaticFlatMap<int, int>(
+        { { 9, 81 }, { 1, 1 }, { 7, 49 }, { 3, 9 }, { 5, 25 }, { 2, 4 }, { 8, 64 } }) };
+
+    for (int key(0); key <= 10; ++key)
+    {
+        const bool isKey{ (key >= 1) && (key <= 9) && (key != 4) && (key != 6) };
+        REQUIRE(map.exists(key) == isKey);
+
+        if (isKey)
+        {
+            REQUIRE(map.at(key) == (key * key));
+        }
+    }
+
+    constexpr auto one{ makeStaticFlatMap<int, char>({ { 5, 'x' } }) };
+    static_assert(one.at(5) == 'x');
+    static_assert(!one.exists(4) && !one.exists(6));
+
+    constexpr auto two{ makeStaticFlatMap<int, char>({ { 5, 'x' }, { 1, 'y' } }) };
+    static_assert((two.at(1) == 'y') && (two.at(5) == 'x'));
+    static_assert(!two.exists(0) && !two.exists(3) && !two.exists(6));
+}
+
+TEST_CASE("StaticFlatMap duplicate keys", "[duplicates]")
+{
+    CHECK_THROWS(makeStaticFlatMap<int, int>({ { 1, 1 }, { 2, 2 }, { 1, 3 } }));
+}
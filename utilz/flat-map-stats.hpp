@@ -0,0 +1,288 @@
+#ifndef FLAT_MAP_STATS_HPP_INCLUDED
+#define FLAT_MAP_STATS_HPP_INCLUDED
+//
+// flat-map-stats.hpp
+//
+// Counts what every FlatMap does so that the ones too big for a linear search can be found.
+// This is all compiled out unless UTILZ_FLAT_MAP_STATS is defined before any include of
+// flat-map.hpp, in which case every FlatMap counts its own lookups and growth:
+//
+//  FlatMap<std::string, int> map;
+//  map.statsTag("loader.cpp opcodes"); // maps with the same tag are added together
+//  ...
+//  std::cout << flatMapStatsReport();
+//
+// A map adds its counts to the report when it is destroyed (or flushStats() is called), so
+// maps that live until exit need a flushStats() before the report.  The counters are relaxed
+// atomics, so many threads can look up in the same const map while counting, but that makes
+// every lookup a little slower and the threads fight over the counters' cache line, so only
+// turn this on to profile.
+//
+// WARNING: UTILZ_FLAT_MAP_STATS changes sizeof(FlatMap) and the code of all its functions, so
+// it must be defined the same way for the whole program, e.g. on the compiler command line of
+// every target that includes flat-map.hpp.  Defining it in only some files breaks the one
+// definition rule, and FlatMaps passed between those files will silently corrupt memory.
+//
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace utilz
+{
+
+    struct FlatMapStats
+    {
+        std::size_t lookups{ 0 };
+        std::size_t hits{ 0 };
+        std::size_t misses{ 0 };
+
+        // how many entries all the lookups compared, which is where the time goes
+        std::size_t scanned{ 0 };
+
+        std::size_t reallocations{ 0 };
+        std::size_t peakSize{ 0 };
+
+        double averageScanned() const noexcept
+        {
+            if (0 == lookups)
+            {
+                return 0.0;
+            }
+
+            return (static_cast<double>(scanned) / static_cast<double>(lookups));
+        }
+
+        void add(const FlatMapStats & other) noexcept
+        {
+            lookups += other.lookups;
+            hits += other.hits;
+            misses += other.misses;
+            scanned += other.scanned;
+            reallocations += other.reallocations;
+            peakSize = std::max(peakSize, other.peakSize);
+        }
+    };
+
+#if defined(UTILZ_FLAT_MAP_STATS)
+
+    // the totals of every destroyed or flushed map, by tag
+    class FlatMapStatsRegistry
+    {
+      public:
+        static void add(const std::string & tag, const FlatMapStats & stats)
+        {
+            std::lock_guard<std::mutex> lock(mutex());
+            totals()[tag].add(stats);
+        }
+
+        static std::vector<std::pair<std::string, FlatMapStats>> all()
+        {
+            std::lock_guard<std::mutex> lock(mutex());
+            return { std::begin(totals()), std::end(totals()) };
+        }
+
+        static void clear()
+        {
+            std::lock_guard<std::mutex> lock(mutex());
+            totals().clear();
+        }
+
+      private:
+        static std::mutex & mutex()
+        {
+            static std::mutex instance;
+            return instance;
+        }
+
+        static std::map<std::string, FlatMapStats> & totals()
+        {
+            static std::map<std::string, FlatMapStats> instance;
+            return instance;
+        }
+    };
+
+    // What each FlatMap holds when counting.  A copy starts counting from zero so that nothing
+    // is counted twice, and a move takes the counts with it.
+    class FlatMapStatsCounter
+    {
+      public:
+        FlatMapStatsCounter()
+            : m_tag("untagged")
+            , m_lookups(0)
+            , m_hits(0)
+            , m_misses(0)
+            , m_scanned(0)
+            , m_reallocations(0)
+            , m_peakSize(0)
+        {}
+
+        FlatMapStatsCounter(const FlatMapStatsCounter & other)
+            : FlatMapStatsCounter()
+        {
+            m_tag = other.m_tag;
+        }
+
+        FlatMapStatsCounter(FlatMapStatsCounter && other) noexcept
+            : FlatMapStatsCounter()
+        {
+            m_tag = other.m_tag;
+            add(other.take());
+        }
+
+        // the tag stays with the map that is assigned to
+        FlatMapStatsCounter & operator=(const FlatMapStatsCounter &) noexcept { return *this; }
+
+        FlatMapStatsCounter & operator=(FlatMapStatsCounter && other) noexcept
+        {
+            add(other.take());
+            return *this;
+        }
+
+        ~FlatMapStatsCounter() { flush(); }
+
+        const char * tag() const noexcept { return m_tag; }
+
+        // changing the tag flushes what was counted under the old one
+        void tag(const char * newTag)
+        {
+            flush();
+            m_tag = newTag;
+        }
+
+        FlatMapStats stats() const noexcept
+        {
+            FlatMapStats stats;
+            stats.lookups = m_lookups.load(std::memory_order_relaxed);
+            stats.hits = m_hits.load(std::memory_order_relaxed);
+            stats.misses = m_misses.load(std::memory_order_relaxed);
+            stats.scanned = m_scanned.load(std::memory_order_relaxed);
+            stats.reallocations = m_reallocations.load(std::memory_order_relaxed);
+            stats.peakSize = m_peakSize.load(std::memory_order_relaxed);
+            return stats;
+        }
+
+        // the only counting done by const functions, so the only one that can be concurrent
+        void countLookup(const std::size_t scanned, const bool wasFound) noexcept
+        {
+            m_lookups.fetch_add(1, std::memory_order_relaxed);
+            m_scanned.fetch_add(scanned, std::memory_order_relaxed);
+
+            if (wasFound)
+            {
+                m_hits.fetch_add(1, std::memory_order_relaxed);
+            }
+            else
+            {
+                m_misses.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        void countGrowth(
+            const std::size_t size,
+            const std::size_t capacityBefore,
+            const std::size_t capacityAfter) noexcept
+        {
+            if (size > m_peakSize.load(std::memory_order_relaxed))
+            {
+                m_peakSize.store(size, std::memory_order_relaxed);
+            }
+
+            if (capacityAfter != capacityBefore)
+            {
+                m_reallocations.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        void flush()
+        {
+            const FlatMapStats stats{ take() };
+
+            if (stats.lookups > 0 || stats.peakSize > 0)
+            {
+                FlatMapStatsRegistry::add(m_tag, stats);
+            }
+        }
+
+      private:
+        // returns the counts and starts again from zero
+        FlatMapStats take() noexcept
+        {
+            FlatMapStats stats;
+            stats.lookups = m_lookups.exchange(0, std::memory_order_relaxed);
+            stats.hits = m_hits.exchange(0, std::memory_order_relaxed);
+            stats.misses = m_misses.exchange(0, std::memory_order_relaxed);
+            stats.scanned = m_scanned.exchange(0, std::memory_order_relaxed);
+            stats.reallocations = m_reallocations.exchange(0, std::memory_order_relaxed);
+            stats.peakSize = m_peakSize.exchange(0, std::memory_order_relaxed);
+            return stats;
+        }
+
+        void add(const FlatMapStats & stats) noexcept
+        {
+            m_lookups.fetch_add(stats.lookups, std::memory_order_relaxed);
+            m_hits.fetch_add(stats.hits, std::memory_order_relaxed);
+            m_misses.fetch_add(stats.misses, std::memory_order_relaxed);
+            m_scanned.fetch_add(stats.scanned, std::memory_order_relaxed);
+            m_reallocations.fetch_add(stats.reallocations, std::memory_order_relaxed);
+            countGrowth(stats.peakSize, 0, 0);
+        }
+
+      private:
+        const char * m_tag;
+        std::atomic<std::size_t> m_lookups;
+        std::atomic<std::size_t> m_hits;
+        std::atomic<std::size_t> m_misses;
+        std::atomic<std::size_t> m_scanned;
+        std::atomic<std::size_t> m_reallocations;
+        std::atomic<std::size_t> m_peakSize;
+    };
+
+#endif
+
+    // A table of every tag, worst average scan first.  Empty if UTILZ_FLAT_MAP_STATS is not on.
+    inline std::string flatMapStatsReport()
+    {
+        std::ostringstream stream;
+
+#if defined(UTILZ_FLAT_MAP_STATS)
+        auto all{ FlatMapStatsRegistry::all() };
+
+        std::sort(std::begin(all), std::end(all), [](const auto & left, const auto & right) {
+            return (left.second.averageScanned() > right.second.averageScanned());
+        });
+
+        stream << std::left << std::setw(32) << "tag" << std::right << std::setw(12) << "lookups"
+               << std::setw(12) << "hits" << std::setw(12) << "misses" << std::setw(14)
+               << "avg scanned" << std::setw(10) << "reallocs" << std::setw(12) << "peak size"
+               << '\n';
+
+        for (const auto & [tag, stats] : all)
+        {
+            stream << std::left << std::setw(32) << tag << std::right << std::setw(12)
+                   << stats.lookups << std::setw(12) << stats.hits << std::setw(12)
+                   << stats.misses << std::setw(14) << std::fixed << std::setprecision(1)
+                   << stats.averageScanned() << std::setw(10) << stats.reallocations
+                   << std::setw(12) << stats.peakSize << '\n';
+        }
+#endif
+
+        return stream.str();
+    }
+
+    inline void clearFlatMapStats()
+    {
+#if defined(UTILZ_FLAT_MAP_STATS)
+        FlatMapStatsRegistry::clear();
+#endif
+    }
+
+} // namespace utilz
+
+#endif // FLAT_MAP_STATS_HPP_INCLUDED
@@ -3,309 +3,1910 @@
 //
 // flat-map.hpp
 //
+#include "utilz/flat-map-stats.hpp"
+#include "utilz/small-vector.hpp"
+
 #include <algorithm>
+#include <array>
 #include <cstddef>
+#include <cstdint>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <optional>
 #include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
-namespace utilz
-{
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
+
+namespace utilz
+{
+
+    // True if K can be compared to key_t with == directly, so that lookups with something like a
+    // std::string_view or a const char * never have to construct a std::string key first.
+    // Numbers are left out so they keep converting to the key_t just like they always have.
+    template <typename key_t, typename K, typename = void>
+    struct IsLookupKey : std::false_type
+    {};
+
+    template <typename key_t, typename K>
+    struct IsLookupKey<
+        key_t,
+        K,
+        std::void_t<decltype(std::declval<const key_t &>() == std::declval<const K &>())>>
+        : std::bool_constant<
+              !std::is_same_v<key_t, K> && !std::is_arithmetic_v<K> && !std::is_enum_v<K>>
+    {};
+
+    template <typename key_t, typename K>
+    using enable_if_lookup_key_t = std::enable_if_t<IsLookupKey<key_t, K>::value>;
+
+    // what FlatMap::insertRange(), assignFrom(), and merge() do with entries that have the same key
+    enum class Duplicates
+    {
+        KeepFirst,
+        KeepLast
+    };
+
+    // what diff(before, after) returns, all sorted by key
+    template <typename key_t, typename data_t>
+    struct FlatMapDiff
+    {
+        FlatMapDiff()
+            : added()
+            , removed()
+            , changed()
+        {}
+
+        bool empty() const noexcept
+        {
+            return (added.empty() && removed.empty() && changed.empty());
+        }
+
+        // only in after
+        std::vector<std::pair<key_t, data_t>> added;
+
+        // only in before, with the data it had there
+        std::vector<std::pair<key_t, data_t>> removed;
+
+        // in both but with different data, with the data it has in after
+        std::vector<std::pair<key_t, data_t>> changed;
+    };
+
+    // What FlatMap::extract() returns, owns an entry moved out of a map (or nothing) until it is
+    // moved into another with insert().  Works with FlatMaps of any storage.
+    template <typename key_t, typename data_t>
+    class FlatMapNode
+    {
+      public:
+        using value_t = std::pair<key_t, data_t>;
+
+        FlatMapNode()
+            : m_pair()
+        {}
+
+        explicit FlatMapNode(value_t && pair)
+            : m_pair(std::move(pair))
+        {}
+
+        FlatMapNode(const FlatMapNode &) = delete;
+        FlatMapNode(FlatMapNode &&) = default;
+
+        FlatMapNode & operator=(const FlatMapNode &) = delete;
+        FlatMapNode & operator=(FlatMapNode &&) = default;
+
+        bool empty() const noexcept { return !m_pair.has_value(); }
+        explicit operator bool() const noexcept { return m_pair.has_value(); }
+
+        // all of these are undefined if empty()
+        key_t & key() noexcept { return m_pair->first; }
+        const key_t & key() const noexcept { return m_pair->first; }
+        data_t & data() noexcept { return m_pair->second; }
+        const data_t & data() const noexcept { return m_pair->second; }
+
+        // moves the entry out, leaving this empty
+        value_t release()
+        {
+            value_t pair{ std::move(*m_pair) };
+            m_pair.reset();
+            return pair;
+        }
+
+      private:
+        std::optional<value_t> m_pair;
+    };
+
+    // the allocator_type of a container, or void if it does not have one (like SmallVector)
+    template <typename container_t, typename = void>
+    struct ContainerAllocator
+    {
+        using type = void;
+    };
+
+    template <typename container_t>
+    struct ContainerAllocator<container_t, std::void_t<typename container_t::allocator_type>>
+    {
+        using type = typename container_t::allocator_type;
+    };
+
+    // the std::vector<bool> of FlatMap tombstones, which allocates from wherever the entries do
+    template <typename allocator_t>
+    struct MarksVector
+    {
+        using type = std::vector<
+            bool,
+            typename std::allocator_traits<allocator_t>::template rebind_alloc<bool>>;
+    };
+
+    template <>
+    struct MarksVector<void>
+    {
+        using type = std::vector<bool>;
+    };
+
+    // Replacement for std::map for those times when you wish it was just a vector.
+    // Not sorted to favor speed, therefore linear run-time and duplicates are possible.
+    // Any vector-like container of pairs can be used instead of std::vector, see SmallFlatMap.
+    //
+    // erase() keeps the order by shifting everything after what was erased, which is a memmove
+    // of the whole tail every time.  For maps with a lot of churn there are two cheaper options:
+    // eraseUnordered() moves the last entry into the hole, and markErased() leaves a tombstone
+    // that compact() removes later along with all the others in a single pass.
+    template <
+        typename key_t,
+        typename data_t,
+        typename storage_t = std::vector<std::pair<key_t, data_t>>>
+    class FlatMap
+    {
+      public:
+        using value_t = std::pair<key_t, data_t>;
+        using container_t = storage_t;
+
+        // named this way because that is what std::uses_allocator and std::pmr look for
+        using allocator_type = typename ContainerAllocator<container_t>::type;
+
+        using iterator_t = typename container_t::iterator;
+        using const_iterator_t = typename container_t::const_iterator;
+        using reverse_iterator_t = std::reverse_iterator<iterator_t>;
+        using const_reverse_iterator_t = std::reverse_iterator<const_iterator_t>;
+        using node_t = FlatMapNode<key_t, data_t>;
+        using marks_t = typename MarksVector<allocator_type>::type;
+
+        FlatMap()
+            : m_vector()
+            , m_marks()
+            , m_markedCount(0)
+#if defined(UTILZ_FLAT_MAP_STATS)
+            , m_statsCounter()
+#endif
+        {}
+
+        // copy, move, and swap all follow the allocator propagation rules of container_t
+        FlatMap(const FlatMap &) = default;
+        FlatMap(FlatMap &&) = default;
+
+        FlatMap & operator=(const FlatMap &) = default;
+        FlatMap & operator=(FlatMap &&) = default;
+
+        // the allocator-extended constructors, only for containers that take an allocator
+        template <
+            typename alloc_t,
+            typename = std::enable_if_t<std::uses_allocator_v<container_t, alloc_t>>>
+        explicit FlatMap(const alloc_t & allocator)
+            : m_vector(allocator)
+            , m_marks(typename marks_t::allocator_type(m_vector.get_allocator()))
+            , m_markedCount(0)
+#if defined(UTILZ_FLAT_MAP_STATS)
+            , m_statsCounter()
+#endif
+        {}
+
+        template <
+            typename alloc_t,
+            typename = std::enable_if_t<std::uses_allocator_v<container_t, alloc_t>>>
+        FlatMap(const FlatMap & other, const alloc_t & allocator)
+            : m_vector(other.m_vector, allocator)
+            , m_marks(other.m_marks, typename marks_t::allocator_type(m_vector.get_allocator()))
+            , m_markedCount(other.m_markedCount)
+#if defined(UTILZ_FLAT_MAP_STATS)
+            , m_statsCounter(other.m_statsCounter)
+#endif
+        {}
+
+        template <
+            typename alloc_t,
+            typename = std::enable_if_t<std::uses_allocator_v<container_t, alloc_t>>>
+        FlatMap(FlatMap && other, const alloc_t & allocator)
+            : m_vector(std::move(other.m_vector), allocator)
+            , m_marks(
+                  std::move(other.m_marks),
+                  typename marks_t::allocator_type(m_vector.get_allocator()))
+            , m_markedCount(other.m_markedCount)
+#if defined(UTILZ_FLAT_MAP_STATS)
+            , m_statsCounter(std::move(other.m_statsCounter))
+#endif
+        {}
+
+        allocator_type getAllocator() const { return m_vector.get_allocator(); }
+
+        void swap(FlatMap & other) noexcept(std::is_nothrow_swappable_v<container_t>)
+        {
+            using std::swap;
+            swap(m_vector, other.m_vector);
+            swap(m_marks, other.m_marks);
+            swap(m_markedCount, other.m_markedCount);
+        }
+
+        // includes entries that are markErased() but not yet compact()'ed
+        bool empty() const noexcept { return m_vector.empty(); }
+        std::size_t size() const noexcept { return m_vector.size(); }
+
+        void clear() noexcept
+        {
+            m_vector.clear();
+            m_marks.clear();
+            m_markedCount = 0;
+        }
+
+        // See flat-map-stats.hpp, these do nothing unless UTILZ_FLAT_MAP_STATS is defined, which
+        // must then be defined for the whole program since it changes sizeof(FlatMap).
+        // The tag is not copied, so it must live as long as the map, like a string literal.
+        void statsTag([[maybe_unused]] const char * tag)
+        {
+#if defined(UTILZ_FLAT_MAP_STATS)
+            m_statsCounter.tag(tag);
+#endif
+        }
+
+        FlatMapStats stats() const
+        {
+#if defined(UTILZ_FLAT_MAP_STATS)
+            return m_statsCounter.stats();
+#else
+            return FlatMapStats();
+#endif
+        }
+
+        // adds the counts so far to flatMapStatsReport() and starts counting again from zero
+        void flushStats()
+        {
+#if defined(UTILZ_FLAT_MAP_STATS)
+            m_statsCounter.flush();
+#endif
+        }
+
+        void reserve(const std::size_t count) { m_vector.reserve(count); }
+        std::size_t capacity() const noexcept { return m_vector.capacity(); }
+        void shrinkToFit() { m_vector.shrink_to_fit(); }
+
+        // All the lookups below can also take anything that compares to key_t with ==, see
+        // IsLookupKey.  operator[] only constructs a key_t from it when it has to insert.
+
+        data_t & operator[](const key_t & key) { return findOrAppend(key); }
+        data_t & operator[](key_t && key) { return findOrAppend(std::move(key)); }
+
+        template <typename K, typename = enable_if_lookup_key_t<key_t, K>>
+        data_t & operator[](const K & key)
+        {
+            return findOrAppend(key);
+        }
+
+        data_t & at(const key_t & key) { return atImpl(key); }
+
+        template <typename K, typename = enable_if_lookup_key_t<key_t, K>>
+        data_t & at(const K & key)
+        {
+            return atImpl(key);
+        }
+
+        const data_t & at(const key_t & key) const { return atImpl(key); }
+
+        template <typename K, typename = enable_if_lookup_key_t<key_t, K>>
+        const data_t & at(const K & key) const
+        {
+            return atImpl(key);
+        }
+
+        // duplicate keys maintained
+        void append(const value_t & pair) { emplaceBack(pair); }
+        void append(value_t && pair) { emplaceBack(std::move(pair)); }
+
+        // moves whichever of the key and data are rvalues instead of copying them
+        template <
+            typename K = key_t,
+            typename D = data_t,
+            typename = std::enable_if_t<
+                std::is_convertible_v<K &&, key_t> && std::is_convertible_v<D &&, data_t>>>
+        void append(K && key, D && data)
+        {
+            emplaceBack(std::forward<K>(key), std::forward<D>(data));
+        }
+
+        // constructs the pair in place from args, duplicate keys maintained just like append()
+        template <typename... Args_t>
+        iterator_t emplace(Args_t &&... args)
+        {
+            emplaceBack(std::forward<Args_t>(args)...);
+            return std::prev(std::end(m_vector));
+        }
+
+        // does nothing (args are not even used) if the key exists, otherwise constructs the data
+        // in place from args, returns (iter, was_inserted)
+        template <typename... Args_t>
+        std::pair<iterator_t, bool> tryEmplace(const key_t & key, Args_t &&... args)
+        {
+            return tryEmplaceImpl(key, std::forward<Args_t>(args)...);
+        }
+
+        template <typename... Args_t>
+        std::pair<iterator_t, bool> tryEmplace(key_t && key, Args_t &&... args)
+        {
+            return tryEmplaceImpl(std::move(key), std::forward<Args_t>(args)...);
+        }
+
+        // assigns to the data if the key exists, otherwise appends, returns (iter, was_inserted)
+        template <typename D>
+        std::pair<iterator_t, bool> insertOrAssign(const key_t & key, D && data)
+        {
+            return insertOrAssignImpl(key, std::forward<D>(data));
+        }
+
+        template <typename D>
+        std::pair<iterator_t, bool> insertOrAssign(key_t && key, D && data)
+        {
+            return insertOrAssignImpl(std::move(key), std::forward<D>(data));
+        }
+
+        // will erase all duplicate keys
+        void erase(const key_t & key) { eraseKey(key); }
+
+        template <typename K, typename = enable_if_lookup_key_t<key_t, K>>
+        void erase(const K & key)
+        {
+            eraseKey(key);
+        }
+
+        iterator_t erase(const const_iterator_t & iter) { return erase(iter, std::next(iter)); }
+
+        iterator_t erase(const const_iterator_t & from, const const_iterator_t & to)
+        {
+            eraseMarks(indexOf(from), indexOf(to));
+            return m_vector.erase(from, to);
+        }
+
+        // erases every entry that pred(const value_t &) is true for in one pass that keeps the
+        // order, instead of the one pass per key of calling erase(key) over and over
+        template <typename Pred_t>
+        void eraseIf(Pred_t pred)
+        {
+            eraseIfOrMarked(pred);
+        }
+
+        // Erases every entry with any of the keys in [first, last), including duplicates, in one
+        // pass that binary searches a sorted list of the keys, so O(n log k) instead of the
+        // O(n * k) of calling erase(key) for each.  Keys that are not a key_t (like a const char *
+        // or a std::string_view) are converted to one first, since their own operator< might not
+        // sort them in the same order as key_t does.
+        template <typename Iter_t>
+        void eraseKeys(const Iter_t first, const Iter_t last)
+        {
+            using probe_key_t = typename std::iterator_traits<Iter_t>::value_type;
+
+            if constexpr (std::is_same_v<probe_key_t, key_t>)
+            {
+                SmallVector<const key_t *, 32> probe;
+                for (Iter_t iter(first); iter != last; ++iter)
+                {
+                    probe.push_back(&*iter);
+                }
+
+                eraseSortedProbe(probe, [](const key_t * key) -> const key_t & { return *key; });
+            }
+            else
+            {
+                SmallVector<key_t, 32> probe;
+                for (Iter_t iter(first); iter != last; ++iter)
+                {
+                    probe.push_back(key_t(*iter));
+                }
+
+                eraseSortedProbe(probe, [](const key_t & key) -> const key_t & { return key; });
+            }
+        }
+
+        // O(1) instead of O(n) because the last entry is moved into the hole, which changes the
+        // order, returns an iterator to whatever was moved in (or end() if it was the last)
+        iterator_t eraseUnordered(const const_iterator_t & iter)
+        {
+            const std::size_t index{ indexOf(iter) };
+            eraseUnorderedAt(index);
+            return std::next(std::begin(m_vector), static_cast<std::ptrdiff_t>(index));
+        }
+
+        // will erase all duplicate keys
+        void eraseUnordered(const key_t & key) { eraseUnorderedKey(key); }
+
+        template <typename K, typename = enable_if_lookup_key_t<key_t, K>>
+        void eraseUnordered(const K & key)
+        {
+            eraseUnorderedKey(key);
+        }
+
+        // Moves the entry out of the map without copying it.  Erases just like erase(), so the
+        // order is kept, and extractUnordered() is the O(1) version that works like
+        // eraseUnordered().  Only the first of any duplicate keys is extracted, and the node is
+        // empty if the key was not found.
+        node_t extract(const const_iterator_t & iter)
+        {
+            node_t node{ std::move(m_vector[indexOf(iter)]) };
+            erase(iter);
+            return node;
+        }
+
+        node_t extract(const key_t & key)
+        {
+            const const_iterator_t iter{ find(key) };
+            return ((iter == std::end(m_vector)) ? node_t() : extract(iter));
+        }
+
+        node_t extractUnordered(const const_iterator_t & iter)
+        {
+            const std::size_t index{ indexOf(iter) };
+            node_t node{ std::move(m_vector[index]) };
+            eraseUnorderedAt(index);
+            return node;
+        }
+
+        node_t extractUnordered(const key_t & key)
+        {
+            const const_iterator_t iter{ find(key) };
+            return ((iter == std::end(m_vector)) ? node_t() : extractUnordered(iter));
+        }
+
+        // Moves the entry of the node into the map, and leaves the node empty, if the key is not
+        // already in the map.  Otherwise the node keeps its entry.  Returns (iter, was_inserted),
+        // with iter at end() if the node was empty.
+        std::pair<iterator_t, bool> insert(node_t && node)
+        {
+            if (node.empty())
+            {
+                return { std::end(m_vector), false };
+            }
+
+            const iterator_t iter{ find(node.key()) };
+            if (iter != std::end(m_vector))
+            {
+                return { iter, false };
+            }
+
+            emplaceBack(node.release());
+            return { std::prev(std::end(m_vector)), true };
+        }
+
+        // Moves every entry that pred(const value_t &) is true for to out, and erases them (and
+        // any tombstones) in one pass that keeps the order of what is left.  Returns out.
+        template <typename Pred_t, typename Out_t>
+        Out_t extractIf(Pred_t pred, Out_t out)
+        {
+            std::size_t keptCount{ 0 };
+            for (std::size_t index(0); index < m_vector.size(); ++index)
+            {
+                if (isMarked(index))
+                {
+                    continue;
+                }
+
+                if (pred(std::as_const(m_vector[index])))
+                {
+                    *out = std::move(m_vector[index]);
+                    ++out;
+                    continue;
+                }
+
+                if (keptCount != index)
+                {
+                    m_vector[keptCount] = std::move(m_vector[index]);
+                }
+
+                ++keptCount;
+            }
+
+            m_vector.erase(
+                std::next(std::begin(m_vector), static_cast<std::ptrdiff_t>(keptCount)),
+                std::end(m_vector));
+
+            m_marks.clear();
+            m_markedCount = 0;
+            return out;
+        }
+
+        // Tombstones: the entry stays where it is (so the order and all iterators stay valid)
+        // but lookups like find(), at(), exists(), and operator[] skip it from now on.  It is
+        // still counted by size(), visited by iteration, and compared until compact().
+        void markErased(const const_iterator_t & iter) { mark(indexOf(iter)); }
+
+        // will mark all duplicate keys
+        void markErased(const key_t & key) { markKey(key); }
+
+        template <typename K, typename = enable_if_lookup_key_t<key_t, K>>
+        void markErased(const K & key)
+        {
+            markKey(key);
+        }
+
+        bool isMarkedErased(const const_iterator_t & iter) const
+        {
+            return isMarked(indexOf(iter));
+        }
+
+        std::size_t markedCount() const noexcept { return m_markedCount; }
+
+        // erases everything markErased() in one pass, keeping the order of what is left
+        void compact()
+        {
+            if (m_markedCount > 0)
+            {
+                eraseIfOrMarked([](const value_t &) { return false; });
+            }
+
+            m_marks.clear();
+        }
+
+        iterator_t find(const key_t & key) { return findImpl(*this, key); }
+
+        template <typename K, typename = enable_if_lookup_key_t<key_t, K>>
+        iterator_t find(const K & key)
+        {
+            return findImpl(*this, key);
+        }
+
+        const_iterator_t find(const key_t & key) const { return findImpl(*this, key); }
+
+        template <typename K, typename = enable_if_lookup_key_t<key_t, K>>
+        const_iterator_t find(const K & key) const
+        {
+            return findImpl(*this, key);
+        }
+
+        bool exists(const key_t & key) const { return (find(key) != std::end(m_vector)); }
+
+        template <typename K, typename = enable_if_lookup_key_t<key_t, K>>
+        bool exists(const K & key) const
+        {
+            return (find(key) != std::end(m_vector));
+        }
+
+        // findMany() just calls find() for fewer keys than this...
+        static constexpr std::size_t findManyMinKeys{ 8 };
+
+        // ...and only merges with more keys than this times log2(size()), since sorting the
+        // entries costs about n log n while each find() costs about n / 2
+        static constexpr std::size_t findManyMergeFactor{ 2 };
+
+        // Looks up every key in [first, last) and writes one iterator per key (end() if not found)
+        // to out, in the same order as the keys, exactly as if find() was called on each.
+        // A map sorted by key with nothing markErased(), like after sortAndUnique(), is binary
+        // searched for each key in O(k log n).  Otherwise, with enough keys, the keys and the
+        // entries are sorted (as indexes, so nothing moves) and then merged in a single pass,
+        // which is O(n log n + k log k) instead of O(n * k).  So this also needs operator< for
+        // the keys, and forward iterators since the keys are read more than once.
+        template <typename Iter_t, typename Out_t>
+        Out_t findMany(const Iter_t first, const Iter_t last, Out_t out)
+        {
+            return findManyImpl(*this, first, last, out);
+        }
+
+        template <typename Iter_t, typename Out_t>
+        Out_t findMany(const Iter_t first, const Iter_t last, Out_t out) const
+        {
+            return findManyImpl(*this, first, last, out);
+        }
+
+        // same as findMany() but writes copies of the data, throws before writing anything if a
+        // key is not found
+        template <typename Iter_t, typename Out_t>
+        Out_t atMany(const Iter_t first, const Iter_t last, Out_t out) const
+        {
+            std::vector<const_iterator_t> found;
+            found.reserve(static_cast<std::size_t>(std::distance(first, last)));
+            findMany(first, last, std::back_inserter(found));
+
+            for (const const_iterator_t & iter : found)
+            {
+                if (iter == std::end(m_vector))
+                {
+                    throw std::out_of_range("FlatMap::atMany()const - key not found");
+                }
+            }
+
+            for (const const_iterator_t & iter : found)
+            {
+                *out++ = iter->second;
+            }
+
+            return out;
+        }
+
+        // sortAndUnique() uses a radix sort for integer and enum keys from this size on...
+        static constexpr std::size_t radixSortMinSize{ 1024 };
+
+        //...and splits other big sorts across all cores from this size on
+        static constexpr std::size_t parallelSortMinSize{ 100'000 };
+
+        // removes all duplicate keys, keeping the first one appended
+        // only compares keys, so data_t does not need operator<
+        void sortAndUnique()
+        {
+            compact();
+
+            const auto keyLess{ [](const value_t & left, const value_t & right) {
+                return (left.first < right.first);
+            } };
+
+            if constexpr (isRadixSortable<key_t>)
+            {
+                if (m_vector.size() >= radixSortMinSize)
+                {
+                    radixSortByKey();
+                }
+                else
+                {
+                    std::stable_sort(std::begin(m_vector), std::end(m_vector), keyLess);
+                }
+            }
+            else if (m_vector.size() >= parallelSortMinSize)
+            {
+                parallelStableSort(std::begin(m_vector), std::end(m_vector), keyLess);
+            }
+            else
+            {
+                std::stable_sort(std::begin(m_vector), std::end(m_vector), keyLess);
+            }
+
+            m_vector.erase(
+                std::unique(
+                    std::begin(m_vector),
+                    std::end(m_vector),
+                    [](const value_t & left, const value_t & right) {
+                        return (left.first == right.first);
+                    }),
+                std::end(m_vector));
+        }
+
+        // Bulk loading that is O(n log n) instead of the O(n^2) of one operator[] per entry.
+        // Appends everything, sorts by key once, and then resolves duplicate keys, including
+        // those that were already in the map (which count as first).  Leaves the map sorted
+        // by key with no duplicates.
+        template <typename Iter_t>
+        void insertRange(
+            const Iter_t first,
+            const Iter_t last,
+            const Duplicates duplicates = Duplicates::KeepFirst)
+        {
+            if (duplicates == Duplicates::KeepFirst)
+            {
+                insertRange(first, last, [](data_t &, data_t &&) {});
+            }
+            else
+            {
+                insertRange(first, last, [](data_t & kept, data_t && duplicate) {
+                    kept = std::move(duplicate);
+                });
+            }
+        }
+
+        // same as above but duplicates are combined with combine(data_t & kept, data_t && other)
+        template <typename Iter_t, typename Combine_t>
+        void insertRange(const Iter_t first, const Iter_t last, Combine_t combine)
+        {
+            compact();
+
+            using category_t = typename std::iterator_traits<Iter_t>::iterator_category;
+            if constexpr (std::is_base_of_v<std::forward_iterator_tag, category_t>)
+            {
+                m_vector.reserve(
+                    m_vector.size() + static_cast<std::size_t>(std::distance(first, last)));
+            }
+
+            for (Iter_t iter(first); iter != last; ++iter)
+            {
+                emplaceBack(*iter);
+            }
+
+            std::stable_sort(
+                std::begin(m_vector), std::end(m_vector), [](const value_t & a, const value_t & b) {
+                    return (a.first < b.first);
+                });
+
+            if (m_vector.empty())
+            {
+                return;
+            }
+
+            iterator_t kept{ std::begin(m_vector) };
+            for (iterator_t iter(std::next(kept)); iter != std::end(m_vector); ++iter)
+            {
+                if (kept->first == iter->first)
+                {
+                    combine(kept->second, std::move(iter->second));
+                }
+                else
+                {
+                    ++kept;
+
+                    if (kept != iter)
+                    {
+                        *kept = std::move(*iter);
+                    }
+                }
+            }
+
+            m_vector.erase(std::next(kept), std::end(m_vector));
+        }
+
+        // replaces everything with the contents of any container of pairs, see insertRange()
+        template <typename Container_t>
+        void assignFrom(
+            const Container_t & container, const Duplicates duplicates = Duplicates::KeepFirst)
+        {
+            clear();
+            insertRange(std::begin(container), std::end(container), duplicates);
+        }
+
+        template <typename Container_t, typename Combine_t>
+        void assignFrom(const Container_t & container, Combine_t combine)
+        {
+            clear();
+            insertRange(std::begin(container), std::end(container), combine);
+        }
+
+        // The functions below that take another map work on the keys lookups would see, so
+        // tombstones are ignored and only the first of any duplicate keys counts.  Both maps are
+        // put in key order with a sort of their positions, which is skipped for maps that are
+        // already sorted by key, so they are O(n log n + m log m) at worst and O(n + m) at best.
+        // They all need key_t to have operator<.
+
+        // Appends the entries of other with keys that are not in this map, in key order.  If
+        // this map was sorted by key it still is after.  For keys that are in both, duplicates
+        // says which data is kept.
+        template <typename other_storage_t>
+        void merge(
+            const FlatMap<key_t, data_t, other_storage_t> & other,
+            const Duplicates duplicates = Duplicates::KeepFirst)
+        {
+            if (duplicates == Duplicates::KeepFirst)
+            {
+                merge(other, [](data_t &, const data_t &) {});
+            }
+            else
+            {
+                merge(other, [](data_t & kept, const data_t & data) { kept = data; });
+            }
+        }
+
+        // same as above but keys in both are combined with combine(data_t & kept, const data_t &)
+        template <typename other_storage_t, typename Combine_t>
+        void merge(const FlatMap<key_t, data_t, other_storage_t> & other, Combine_t combine)
+        {
+            compact();
+
+            const bool wasSorted{ std::is_sorted(
+                std::begin(m_vector), std::end(m_vector), [](const value_t & a, const value_t & b) {
+                    return (a.first < b.first);
+                }) };
+
+            const key_order_t mine{ keyOrder(*this, true) };
+            const key_order_t theirs{ keyOrder(other, true) };
+            const std::size_t sizeBefore{ m_vector.size() };
+
+            auto mineIter{ std::begin(mine) };
+            for (const std::size_t theirIndex : theirs)
+            {
+                const value_t & pair{ std::begin(other)[static_cast<std::ptrdiff_t>(theirIndex)] };
+
+                while ((mineIter != std::end(mine)) && (m_vector[*mineIter].first < pair.first))
+                {
+                    ++mineIter;
+                }
+
+                if ((mineIter != std::end(mine)) && !(pair.first < m_vector[*mineIter].first))
+                {
+                    combine(m_vector[*mineIter].second, pair.second);
+                }
+                else
+                {
+                    emplaceBack(pair);
+                }
+            }
+
+            if (wasSorted)
+            {
+                std::inplace_merge(
+                    std::begin(m_vector),
+                    std::next(std::begin(m_vector), static_cast<std::ptrdiff_t>(sizeBefore)),
+                    std::end(m_vector),
+                    [](const value_t & a, const value_t & b) { return (a.first < b.first); });
+            }
+        }
+
+        // erases every entry with a key that is not in other, keeps the order of what is left
+        template <typename other_storage_t>
+        void intersectKeys(const FlatMap<key_t, data_t, other_storage_t> & other)
+        {
+            eraseByKeysIn(other, false);
+        }
+
+        // erases every entry with a key that is in other, keeps the order of what is left
+        template <typename other_storage_t>
+        void subtractKeys(const FlatMap<key_t, data_t, other_storage_t> & other)
+        {
+            eraseByKeysIn(other, true);
+        }
+
+        constexpr iterator_t begin() noexcept { return std::begin(m_vector); }
+        constexpr iterator_t end() noexcept { return std::end(m_vector); }
+
+        constexpr const_iterator_t begin() const noexcept { return std::begin(m_vector); }
+        constexpr const_iterator_t end() const noexcept { return std::end(m_vector); }
+
+        constexpr const_iterator_t cbegin() const noexcept { return begin(); }
+        constexpr const_iterator_t cend() const noexcept { return end(); }
+
+        constexpr reverse_iterator_t rbegin() noexcept { return reverse_iterator_t(end()); }
+        constexpr reverse_iterator_t rend() noexcept { return reverse_iterator_t(begin()); }
+
+        constexpr const_reverse_iterator_t rbegin() const noexcept
+        {
+            return const_reverse_iterator_t(end());
+        }
+
+        constexpr const_reverse_iterator_t rend() const noexcept
+        {
+            return const_reverse_iterator_t(begin());
+        }
+
+        constexpr const_reverse_iterator_t crbegin() const noexcept { return rbegin(); }
+        constexpr const_reverse_iterator_t crend() const noexcept { return rend(); }
+
+        // clang-format off
+        template<typename T, typename U, typename C>
+        friend bool
+            operator==(const FlatMap<T, U, C> & left, const FlatMap<T, U, C> & right);
+
+        template<typename T, typename U, typename C>
+        friend bool
+            operator<(const FlatMap<T, U, C> & left, const FlatMap<T, U, C> & right);
+
+        template<typename T, typename U, typename C, typename C2>
+        friend FlatMapDiff<T, U>
+            diff(const FlatMap<T, U, C> & before, const FlatMap<T, U, C2> & after);
+        // clang-format on
+
+      private:
+        // one version for both const and non-const maps
+        template <typename map_t, typename K>
+        static auto findImpl(map_t & map, const K & key)
+        {
+            auto iter{ std::begin(map.m_vector) };
+
+            if (0 == map.m_markedCount)
+            {
+                iter = std::find_if(
+                    std::begin(map.m_vector), std::end(map.m_vector), [&](const value_t & pair) {
+                        return (pair.first == key);
+                    });
+            }
+            else
+            {
+                for (std::size_t index(0); iter != std::end(map.m_vector); ++iter, ++index)
+                {
+                    if ((iter->first == key) && !map.isMarked(index))
+                    {
+                        break;
+                    }
+                }
+            }
+
+            map.countLookup(iter);
+            return iter;
+        }
+
+        // every append goes through here so that growth can be counted, see flat-map-stats.hpp
+        template <typename... Args_t>
+        void emplaceBack(Args_t &&... args)
+        {
+#if defined(UTILZ_FLAT_MAP_STATS)
+            const std::size_t capacityBefore{ m_vector.capacity() };
+            m_vector.emplace_back(std::forward<Args_t>(args)...);
+            m_statsCounter.countGrowth(m_vector.size(), capacityBefore, m_vector.capacity());
+#else
+            m_vector.emplace_back(std::forward<Args_t>(args)...);
+#endif
+        }
+
+        template <typename Iter_t>
+        void countLookup([[maybe_unused]] const Iter_t iter) const
+        {
+#if defined(UTILZ_FLAT_MAP_STATS)
+            const bool wasFound{ iter != std::end(m_vector) };
+
+            const std::size_t scanned{ wasFound ? (indexOf(iter) + 1) : m_vector.size() };
+            m_statsCounter.countLookup(scanned, wasFound);
+#endif
+        }
+
+        void countLookup(
+            [[maybe_unused]] const std::size_t scanned, [[maybe_unused]] const bool wasFound) const
+        {
+#if defined(UTILZ_FLAT_MAP_STATS)
+            m_statsCounter.countLookup(scanned, wasFound);
+#endif
+        }
+
+        template <typename map_t, typename Iter_t, typename Out_t>
+        static Out_t findManyImpl(map_t & map, const Iter_t first, const Iter_t last, Out_t out)
+        {
+            static_assert(
+                std::is_base_of_v<
+                    std::forward_iterator_tag,
+                    typename std::iterator_traits<Iter_t>::iterator_category>,
+                "FlatMap::findMany() needs forward iterators, the keys are read more than once.");
+
+            const auto & vector{ map.m_vector };
+            const std::size_t keyCount{ static_cast<std::size_t>(std::distance(first, last)) };
+
+            std::size_t sizeLog2{ 0 };
+            for (std::size_t size(vector.size()); size > 1; size /= 2)
+            {
+                ++sizeLog2;
+            }
+
+            const auto pairLess{ [](const value_t & left, const value_t & right) {
+                return (left.first < right.first);
+            } };
+
+            // sorted maps need no copy, duplicates are next to each other so the first is found
+            if ((keyCount >= findManyMinKeys) && (0 == map.m_markedCount) &&
+                std::is_sorted(std::begin(vector), std::end(vector), pairLess))
+            {
+                for (Iter_t iter(first); iter != last; ++iter)
+                {
+                    const auto & key{ *iter };
+
+                    auto found{ std::lower_bound(
+                        std::begin(map.m_vector),
+                        std::end(map.m_vector),
+                        key,
+                        [](const value_t & pair, const auto & probe) {
+                            return (pair.first < probe);
+                        }) };
+
+                    const bool wasFound{ (found != std::end(map.m_vector)) &&
+                                         (found->first == key) };
+
+                    map.countLookup((sizeLog2 + 1), wasFound);
+                    *out++ = (wasFound ? found : std::end(map.m_vector));
+                }
+
+                return out;
+            }
+
+            if ((keyCount < findManyMinKeys) || (keyCount <= (findManyMergeFactor * sizeLog2)))
+            {
+                for (Iter_t iter(first); iter != last; ++iter)
+                {
+                    *out++ = findImpl(map, *iter);
+                }
+
+                return out;
+            }
+
+            // everything find() can see, sorted by key with duplicates in the order find() sees
+            std::vector<std::size_t> entries;
+            entries.reserve(vector.size());
+            for (std::size_t index(0); index < vector.size(); ++index)
+            {
+                if (!map.isMarked(index))
+                {
+                    entries.push_back(index);
+                }
+            }
+
+            const auto entryLess{ [&](const std::size_t left, const std::size_t right) {
+                return (vector[left].first < vector[right].first);
+            } };
+
+            if (!std::is_sorted(std::begin(entries), std::end(entries), entryLess))
+            {
+                std::stable_sort(std::begin(entries), std::end(entries), entryLess);
+            }
+
+            std::vector<Iter_t> keys;
+            keys.reserve(keyCount);
+            for (Iter_t iter(first); iter != last; ++iter)
+            {
+                keys.push_back(iter);
+            }
+
+            std::vector<std::size_t> keyOrder(keyCount);
+            for (std::size_t i(0); i < keyCount; ++i)
+            {
+                keyOrder[i] = i;
+            }
+
+            std::sort(
+                std::begin(keyOrder),
+                std::end(keyOrder),
+                [&](const std::size_t left, const std::size_t right) {
+                    return (*keys[left] < *keys[right]);
+                });
+
+            // the merge, with size() meaning not found
+            std::vector<std::size_t> found(keyCount, vector.size());
+            auto entry{ std::begin(entries) };
+            for (const std::size_t keyIndex : keyOrder)
+            {
+                const auto & key{ *keys[keyIndex] };
+                const auto entryBefore{ entry };
+
+                while ((entry != std::end(entries)) && (vector[*entry].first < key))
+                {
+                    ++entry;
+                }
+
+                const bool wasFound{ (entry != std::end(entries)) &&
+                                     (vector[*entry].first == key) };
+
+                if (wasFound)
+                {
+                    found[keyIndex] = *entry;
+                }
+
+                // counted as the entries this key stepped over plus the one it stopped at
+                const auto stepped{ static_cast<std::size_t>(entry - entryBefore) };
+                map.countLookup((stepped + ((entry != std::end(entries)) ? 1 : 0)), wasFound);
+            }
+
+            for (const std::size_t position : found)
+            {
+                *out++ = std::next(std::begin(map.m_vector), static_cast<std::ptrdiff_t>(position));
+            }
+
+            return out;
+        }
+
+        template <typename K>
+        data_t & findOrAppend(K && key)
+        {
+            const iterator_t iter{ findImpl(*this, key) };
+            if (iter != std::end(m_vector))
+            {
+                return iter->second;
+            }
+
+            emplaceBack(
+                std::piecewise_construct,
+                std::forward_as_tuple(std::forward<K>(key)),
+                std::forward_as_tuple());
+
+            return m_vector[m_vector.size() - 1].second;
+        }
+
+        template <typename K, typename... Args_t>
+        std::pair<iterator_t, bool> tryEmplaceImpl(K && key, Args_t &&... args)
+        {
+            const iterator_t iter{ find(key) };
+
+            if (iter != std::end(m_vector))
+            {
+                return { iter, false };
+            }
+
+            emplaceBack(
+                std::piecewise_construct,
+                std::forward_as_tuple(std::forward<K>(key)),
+                std::forward_as_tuple(std::forward<Args_t>(args)...));
+
+            return { std::prev(std::end(m_vector)), true };
+        }
+
+        template <typename K, typename D>
+        std::pair<iterator_t, bool> insertOrAssignImpl(K && key, D && data)
+        {
+            const iterator_t iter{ find(key) };
+
+            if (iter != std::end(m_vector))
+            {
+                iter->second = std::forward<D>(data);
+                return { iter, false };
+            }
+
+            emplaceBack(std::forward<K>(key), std::forward<D>(data));
+            return { std::prev(std::end(m_vector)), true };
+        }
+
+        template <typename K>
+        data_t & atImpl(const K & key)
+        {
+            const iterator_t iter{ findImpl(*this, key) };
+            if (iter != std::end(m_vector))
+            {
+                return iter->second;
+            }
+
+            throw std::out_of_range("FlatMap::at() - key not found");
+        }
+
+        template <typename K>
+        const data_t & atImpl(const K & key) const
+        {
+            const const_iterator_t iter{ findImpl(*this, key) };
+            if (iter != std::end(m_vector))
+            {
+                return iter->second;
+            }
+
+            throw std::out_of_range("FlatMap::at()const - key not found");
+        }
+
+        // The compares see maps as if they were sorted, so that order does not matter.  Sorting
+        // pointers instead of copies of the pairs means maps of up to 32 entries never allocate
+        // to compare, and bigger ones allocate one pointer per entry instead of copying pairs.
+        using sorted_view_t = SmallVector<const value_t *, 32>;
+
+        template <typename Less_t>
+        static sorted_view_t
+            sortedView(const const_iterator_t first, const const_iterator_t last, Less_t less)
+        {
+            sorted_view_t view;
+            view.reserve(static_cast<std::size_t>(std::distance(first, last)));
+
+            for (const_iterator_t iter(first); iter != last; ++iter)
+            {
+                view.push_back(&*iter);
+            }
+
+            std::stable_sort(
+                std::begin(view),
+                std::end(view),
+                [&](const value_t * left, const value_t * right) { return less(*left, *right); });
+
+            return view;
+        }
+
+        // The positions of the entries of map sorted by key, skipping tombstones.  If onlyFirst
+        // then only the entry lookups would find is kept for each key.  This is only a stable
+        // sort of positions, which is skipped when the map is already sorted by key.
+        using key_order_t = SmallVector<std::size_t, 32>;
+
+        template <typename map_t>
+        static key_order_t keyOrder(const map_t & map, const bool onlyFirst)
+        {
+            const auto first{ std::begin(map) };
+
+            key_order_t order;
+            order.reserve(map.size());
+
+            std::size_t index{ 0 };
+            for (auto iter(first); iter != std::end(map); ++iter, ++index)
+            {
+                if (!map.isMarkedErased(iter))
+                {
+                    order.push_back(index);
+                }
+            }
+
+            const auto keyOf{ [&](const std::size_t i) -> const key_t & {
+                return first[static_cast<std::ptrdiff_t>(i)].first;
+            } };
+
+            const auto positionLess{ [&](const std::size_t left, const std::size_t right) {
+                return (keyOf(left) < keyOf(right));
+            } };
+
+            if (!std::is_sorted(std::begin(order), std::end(order), positionLess))
+            {
+                std::stable_sort(std::begin(order), std::end(order), positionLess);
+            }
+
+            if (onlyFirst)
+            {
+                order.erase(
+                    std::unique(
+                        std::begin(order),
+                        std::end(order),
+                        [&](const std::size_t left, const std::size_t right) {
+                            return !positionLess(left, right);
+                        }),
+                    std::end(order));
+            }
+
+            return order;
+        }
+
+        // sorts probe by keyOf(probe entry) and then erases every entry with a key found in it
+        template <typename Probe_t, typename KeyOf_t>
+        void eraseSortedProbe(Probe_t & probe, KeyOf_t keyOf)
+        {
+            std::sort(
+                std::begin(probe), std::end(probe), [&](const auto & left, const auto & right) {
+                    return (keyOf(left) < keyOf(right));
+                });
 
-    // Replacement for std::map for those times when you wish it was just a vector.
-    // Not sorted to favor speed, therefore linear run-time and duplicates are possible.
-    template <typename key_t, typename data_t>
-    class FlatMap
-    {
-      public:
-        using value_t = std::pair<key_t, data_t>;
-        using container_t = std::vector<value_t>;
-        using iterator_t = typename container_t::iterator;
-        using const_iterator_t = typename container_t::const_iterator;
-        using reverse_iterator_t = std::reverse_iterator<iterator_t>;
-        using const_reverse_iterator_t = std::reverse_iterator<const_iterator_t>;
+            eraseIfOrMarked([&](const value_t & pair) {
+                const auto iter{ std::lower_bound(
+                    std::begin(probe),
+                    std::end(probe),
+                    pair.first,
+                    [&](const auto & probeKey, const key_t & key) {
+                        return (keyOf(probeKey) < key);
+                    }) };
 
-        FlatMap()
-            : m_vector()
-        {}
+                return ((iter != std::end(probe)) && !(pair.first < keyOf(*iter)));
+            });
+        }
 
-        FlatMap(const FlatMap &) = default;
-        FlatMap(FlatMap &&) = default;
+        // one merge of the two key orders that marks what to erase, and then one compact()
+        template <typename map_t>
+        void eraseByKeysIn(const map_t & other, const bool eraseIfInOther)
+        {
+            const key_order_t mine{ keyOrder(*this, false) };
+            const key_order_t theirs{ keyOrder(other, true) };
+            const auto otherFirst{ std::begin(other) };
 
-        FlatMap & operator=(const FlatMap &) = default;
-        FlatMap & operator=(FlatMap &&) = default;
+            auto theirIter{ std::begin(theirs) };
+            for (const std::size_t index : mine)
+            {
+                const key_t & key{ m_vector[index].first };
 
-        bool empty() const noexcept { return m_vector.empty(); }
-        std::size_t size() const noexcept { return m_vector.size(); }
-        void clear() noexcept { m_vector.clear(); }
+                while ((theirIter != std::end(theirs)) &&
+                       (otherFirst[static_cast<std::ptrdiff_t>(*theirIter)].first < key))
+                {
+                    ++theirIter;
+                }
 
-        void reserve(const std::size_t count) { m_vector.reserve(count); }
-        std::size_t capacity() const noexcept { return m_vector.capacity(); }
-        void shrinkToFit() { m_vector.shrink_to_fit(); }
+                const bool isInOther{ (theirIter != std::end(theirs)) &&
+                                      !(key < otherFirst[static_cast<std::ptrdiff_t>(*theirIter)]
+                                                  .first) };
 
-        data_t & operator[](const key_t & key)
+                if (isInOther == eraseIfInOther)
+                {
+                    mark(index);
+                }
+            }
+
+            compact();
+        }
+
+        template <typename T>
+        static constexpr bool isRadixSortable =
+            ((std::is_integral_v<T> && !std::is_same_v<T, bool>) || std::is_enum_v<T>) &&
+            (sizeof(T) <= sizeof(std::uint64_t));
+
+        // maps a key to an unsigned number that sorts in the same order
+        template <typename T>
+        static std::uint64_t radixBitsOf(const T key) noexcept
         {
-            for (value_t & pair : m_vector)
+            if constexpr (std::is_enum_v<T>)
+            {
+                return radixBitsOf(static_cast<std::underlying_type_t<T>>(key));
+            }
+            else
             {
-                if (key == pair.first)
+                using unsigned_t = std::make_unsigned_t<T>;
+                std::uint64_t bits{ static_cast<unsigned_t>(key) };
+
+                if constexpr (std::is_signed_v<T>)
                 {
-                    return pair.second;
+                    bits ^= (std::uint64_t(1) << ((sizeof(T) * 8) - 1));
                 }
-            }
 
-            m_vector.emplace_back(key, data_t{});
-            return m_vector[m_vector.size() - 1].second;
+                return bits;
+            }
         }
 
-        data_t & at(const key_t & key)
+        // A stable LSD radix sort of (key bits, position) pairs, one byte per pass, skipping
+        // bytes that are the same in every key.  The pairs are then moved into that order by
+        // following the cycles of the permutation, so nothing is copied and nothing is allocated
+        // that needs data_t.
+        void radixSortByKey()
         {
-            for (value_t & pair : m_vector)
+            struct Entry
+            {
+                std::uint64_t bits;
+                std::size_t position;
+            };
+
+            const std::size_t count{ m_vector.size() };
+            std::vector<Entry> entries(count);
+            std::vector<Entry> buffer(count);
+
+            for (std::size_t i(0); i < count; ++i)
             {
-                if (key == pair.first)
+                entries[i] = { radixBitsOf(m_vector[i].first), i };
+            }
+
+            for (std::size_t byte(0); byte < sizeof(key_t); ++byte)
+            {
+                const std::size_t shift{ byte * 8 };
+
+                std::array<std::size_t, 256> offsets{};
+                for (const Entry & entry : entries)
+                {
+                    ++offsets[static_cast<std::size_t>((entry.bits >> shift) & 0xFF)];
+                }
+
+                if (std::find(std::begin(offsets), std::end(offsets), count) != std::end(offsets))
+                {
+                    continue;
+                }
+
+                std::size_t total{ 0 };
+                for (std::size_t & offset : offsets)
+                {
+                    const std::size_t bucketSize{ offset };
+                    offset = total;
+                    total += bucketSize;
+                }
+
+                for (const Entry & entry : entries)
                 {
-                    return pair.second;
+                    buffer[offsets[static_cast<std::size_t>((entry.bits >> shift) & 0xFF)]++] =
+                        entry;
                 }
+
+                entries.swap(buffer);
             }
 
-            throw std::out_of_range("FlatMap::at() - key not found");
+            for (std::size_t start(0); start < count; ++start)
+            {
+                if (entries[start].position == start)
+                {
+                    continue;
+                }
+
+                value_t temp(std::move(m_vector[start]));
+
+                std::size_t destination{ start };
+                while (true)
+                {
+                    const std::size_t source{ entries[destination].position };
+                    entries[destination].position = destination;
+
+                    if (source == start)
+                    {
+                        m_vector[destination] = std::move(temp);
+                        break;
+                    }
+
+                    m_vector[destination] = std::move(m_vector[source]);
+                    destination = source;
+                }
+            }
         }
 
-        const data_t & at(const key_t & key) const
+        // Stable sorts one chunk per core at the same time, and then merges neighboring chunks
+        // (also at the same time) until there is only one.  std::async is used so that any
+        // exceptions make it back to this thread.
+        template <typename Iter_t, typename Less_t>
+        static void parallelStableSort(const Iter_t first, const Iter_t last, Less_t less)
         {
-            for (const value_t & pair : m_vector)
+            const std::size_t count{ static_cast<std::size_t>(std::distance(first, last)) };
+            const std::size_t chunkCount{ std::clamp(
+                static_cast<std::size_t>(std::thread::hardware_concurrency()),
+                std::size_t(1),
+                std::max(std::size_t(1), (count / 1024))) };
+
+            std::vector<Iter_t> bounds;
+            for (std::size_t i(0); i < chunkCount; ++i)
+            {
+                bounds.push_back(first + static_cast<std::ptrdiff_t>((count * i) / chunkCount));
+            }
+            bounds.push_back(last);
+
+            std::vector<std::future<void>> futures;
+
+            for (std::size_t i(0); (i + 1) < bounds.size(); ++i)
+            {
+                futures.push_back(std::async(std::launch::async, [&, i]() {
+                    std::stable_sort(bounds[i], bounds[i + 1], less);
+                }));
+            }
+
+            for (std::future<void> & future : futures)
+            {
+                future.get();
+            }
+
+            while (bounds.size() > 2)
             {
-                if (key == pair.first)
+                futures.clear();
+
+                std::vector<Iter_t> mergedBounds;
+                for (std::size_t i(0); (i + 1) < bounds.size(); i += 2)
                 {
-                    return pair.second;
+                    mergedBounds.push_back(bounds[i]);
+
+                    if ((i + 2) < bounds.size())
+                    {
+                        futures.push_back(std::async(std::launch::async, [&, i]() {
+                            std::inplace_merge(bounds[i], bounds[i + 1], bounds[i + 2], less);
+                        }));
+                    }
                 }
-            }
+                mergedBounds.push_back(last);
 
-            throw std::out_of_range("FlatMap::at()const - key not found");
+                for (std::future<void> & future : futures)
+                {
+                    future.get();
+                }
+
+                bounds.swap(mergedBounds);
+            }
         }
 
-        // duplicate keys maintained
-        void append(const value_t & pair) { m_vector.push_back(pair); }
-        void append(const key_t & key, const data_t & data) { m_vector.emplace_back(key, data); }
+        template <typename K>
+        void eraseKey(const K & key)
+        {
+            eraseIfOrMarked([&](const value_t & pair) { return (pair.first == key); });
+        }
 
-        // will erase all duplicate keys
-        void erase(const key_t & key)
+        // one pass that also takes out all the tombstones, since the marks would be wrong after
+        template <typename Pred_t>
+        void eraseIfOrMarked(Pred_t isDoomed)
         {
+            if (0 == m_markedCount)
+            {
+                m_vector.erase(
+                    std::remove_if(std::begin(m_vector), std::end(m_vector), isDoomed),
+                    std::end(m_vector));
+
+                m_marks.clear();
+                return;
+            }
+
+            std::size_t keptCount{ 0 };
+            for (std::size_t index(0); index < m_vector.size(); ++index)
+            {
+                if (isMarked(index) || isDoomed(m_vector[index]))
+                {
+                    continue;
+                }
+
+                if (keptCount != index)
+                {
+                    m_vector[keptCount] = std::move(m_vector[index]);
+                }
+
+                ++keptCount;
+            }
+
             m_vector.erase(
-                std::remove_if(
-                    std::begin(m_vector),
-                    std::end(m_vector),
-                    [&](const value_t & pair) { return (key == pair.first); }),
+                std::next(std::begin(m_vector), static_cast<std::ptrdiff_t>(keptCount)),
                 std::end(m_vector));
-        }
 
-        iterator_t erase(const const_iterator_t & iter) { return m_vector.erase(iter); }
+            m_marks.clear();
+            m_markedCount = 0;
+        }
 
-        iterator_t erase(const const_iterator_t & from, const const_iterator_t & to)
+        std::size_t indexOf(const const_iterator_t & iter) const
         {
-            return m_vector.erase(from, to);
+            return static_cast<std::size_t>(std::distance(std::cbegin(m_vector), iter));
         }
 
-        iterator_t find(key_t & key)
+        // m_marks can be shorter than m_vector so that appending never has to touch it
+        bool isMarked(const std::size_t index) const
         {
-            return std::find_if(
-                std::begin(m_vector), std::end(m_vector), [&](const value_t & pair) {
-                    return (pair.first == key);
-                });
+            return ((index < m_marks.size()) && m_marks[index]);
         }
 
-        const_iterator_t find(const key_t & key) const
+        void mark(const std::size_t index)
         {
-            return std::find_if(
-                std::begin(m_vector), std::end(m_vector), [&](const value_t & pair) {
-                    return (pair.first == key);
-                });
+            if (isMarked(index))
+            {
+                return;
+            }
+
+            if (index >= m_marks.size())
+            {
+                m_marks.resize(m_vector.size(), false);
+            }
+
+            m_marks[index] = true;
+            ++m_markedCount;
         }
 
-        bool exists(const key_t & key) const { return (find(key) != std::end(m_vector)); }
+        template <typename K>
+        void markKey(const K & key)
+        {
+            for (std::size_t index(0); index < m_vector.size(); ++index)
+            {
+                if (m_vector[index].first == key)
+                {
+                    mark(index);
+                }
+            }
+        }
 
-        // removes all duplicate keys
-        void sortAndUnique()
+        // keeps m_marks lined up with m_vector when [first, last) is erased from it
+        void eraseMarks(const std::size_t first, const std::size_t last)
         {
-            std::sort(std::begin(m_vector), std::end(m_vector));
+            if (first >= m_marks.size())
+            {
+                return;
+            }
 
-            m_vector.erase(
-                std::unique(
-                    std::begin(m_vector),
-                    std::end(m_vector),
-                    [](const value_t & left, const value_t & right) {
-                        return (left.first == right.first);
-                    }),
-                std::end(m_vector));
+            const auto from{ std::next(std::begin(m_marks), static_cast<std::ptrdiff_t>(first)) };
+            const auto to{ std::next(
+                std::begin(m_marks),
+                static_cast<std::ptrdiff_t>(std::min(last, m_marks.size()))) };
+
+            m_markedCount -= static_cast<std::size_t>(std::count(from, to, true));
+            m_marks.erase(from, to);
         }
 
-        constexpr iterator_t begin() noexcept { return std::begin(m_vector); }
-        constexpr iterator_t end() noexcept { return std::end(m_vector); }
+        void eraseUnorderedAt(const std::size_t index)
+        {
+            const std::size_t lastIndex{ m_vector.size() - 1 };
 
-        constexpr const_iterator_t begin() const noexcept { return std::begin(m_vector); }
-        constexpr const_iterator_t end() const noexcept { return std::end(m_vector); }
+            if (index != lastIndex)
+            {
+                m_vector[index] = std::move(m_vector[lastIndex]);
+            }
 
-        constexpr const_iterator_t cbegin() const noexcept { return begin(); }
-        constexpr const_iterator_t cend() const noexcept { return end(); }
+            m_vector.pop_back();
 
-        constexpr reverse_iterator_t rbegin() noexcept { return reverse_iterator_t(end()); }
-        constexpr reverse_iterator_t rend() noexcept { return reverse_iterator_t(begin()); }
+            // the mark moves along with the entry, and there is always a mark for index if the
+            // last entry had one because m_marks is never longer than m_vector
+            if (index < m_marks.size())
+            {
+                if (m_marks[index])
+                {
+                    --m_markedCount;
+                }
 
-        constexpr const_reverse_iterator_t rbegin() const noexcept
-        {
-            return const_reverse_iterator_t(end());
+                m_marks[index] = isMarked(lastIndex);
+            }
+
+            if (m_marks.size() > m_vector.size())
+            {
+                m_marks.resize(m_vector.size());
+            }
         }
 
-        constexpr const_reverse_iterator_t rend() const noexcept
+        template <typename K>
+        void eraseUnorderedKey(const K & key)
         {
-            return const_reverse_iterator_t(begin());
+            std::size_t index{ 0 };
+            while (index < m_vector.size())
+            {
+                if (m_vector[index].first == key)
+                {
+                    eraseUnorderedAt(index);
+                }
+                else
+                {
+                    ++index;
+                }
+            }
         }
 
-        constexpr const_reverse_iterator_t crbegin() const noexcept { return rbegin(); }
-        constexpr const_reverse_iterator_t crend() const noexcept { return rend(); }
-
-        // clang-format off
-        template<typename T, typename U>
-        friend bool
-            operator==(const FlatMap<T, U> & left, const FlatMap<T, U> & right);
-
-        template<typename T, typename U>
-        friend bool
-            operator<(const FlatMap<T, U> & left, const FlatMap<T, U> & right);
-        // clang-format on
-
       private:
         container_t m_vector;
+
+        // the tombstones of markErased(), empty unless that is used, see isMarked()
+        marks_t m_marks;
+        std::size_t m_markedCount;
+
+#if defined(UTILZ_FLAT_MAP_STATS)
+        // Mutable because const lookups are counted too.  This member is why the macro must be
+        // defined the same way for the whole program, see flat-map-stats.hpp.
+        mutable FlatMapStatsCounter m_statsCounter;
+#endif
     };
 
     //
 
-    template <typename key_t, typename data_t>
-    bool operator==(const FlatMap<key_t, data_t> & left, const FlatMap<key_t, data_t> & right)
+    // Maps are equal if they hold the same entries in any order, duplicate keys included.
+    // Only needs operator== for the data, since the entries are sorted by key alone and then the
+    // data of each key is compared in any order.  Maps that are not in the same order are sorted
+    // as a view of pointers, which allocates one pointer per entry for maps over 32 entries.
+    template <typename key_t, typename data_t, typename container_t>
+    bool operator==(
+        const FlatMap<key_t, data_t, container_t> & left,
+        const FlatMap<key_t, data_t, container_t> & right)
     {
         if (left.size() != right.size())
         {
             return false;
         }
 
-        typename FlatMap<key_t, data_t>::container_t leftVec{ left.m_vector };
-        typename FlatMap<key_t, data_t>::container_t rightVec{ right.m_vector };
+        // the matching front of both needs no sorting, which is all of it for unchanged copies
+        const auto [leftIter, rightIter] =
+            std::mismatch(std::begin(left), std::end(left), std::begin(right));
+
+        if (leftIter == std::end(left))
+        {
+            return true;
+        }
+
+        const auto keyLess{ [](const auto & leftPair, const auto & rightPair) {
+            return (leftPair.first < rightPair.first);
+        } };
+
+        const auto isNotAfter{ [&](const auto & leftPair, const auto & rightPair) {
+            return !keyLess(leftPair, rightPair);
+        } };
+
+        // with unique sorted keys, two that start with different entries can't hold the same
+        if ((std::adjacent_find(leftIter, std::end(left), isNotAfter) == std::end(left)) &&
+            (std::adjacent_find(rightIter, std::end(right), isNotAfter) == std::end(right)))
+        {
+            return false;
+        }
+
+        using map_t = FlatMap<key_t, data_t, container_t>;
+        const auto leftView{ map_t::sortedView(leftIter, std::end(left), keyLess) };
+        const auto rightView{ map_t::sortedView(rightIter, std::end(right), keyLess) };
+
+        const auto pairEqual{ [](const auto * leftPair, const auto * rightPair) {
+            return (*leftPair == *rightPair);
+        } };
+
+        // each run of one key must hold the same entries as the other's, in any order
+        auto leftRun{ std::begin(leftView) };
+        auto rightRun{ std::begin(rightView) };
+        while (leftRun != std::end(leftView))
+        {
+            const auto isLaterKey{ [&](const auto * pair) {
+                return ((*leftRun)->first < pair->first);
+            } };
+
+            const auto leftRunEnd{ std::find_if(leftRun, std::end(leftView), isLaterKey) };
+            const auto rightRunEnd{ std::find_if(rightRun, std::end(rightView), isLaterKey) };
+
+            if (!std::is_permutation(leftRun, leftRunEnd, rightRun, rightRunEnd, pairEqual))
+            {
+                return false;
+            }
 
-        std::sort(std::begin(leftVec), std::end(leftVec));
-        std::sort(std::begin(leftVec), std::end(leftVec));
+            leftRun = leftRunEnd;
+            rightRun = rightRunEnd;
+        }
 
-        return (leftVec == rightVec);
+        return true;
     }
 
-    template <typename key_t, typename data_t>
-    bool operator!=(const FlatMap<key_t, data_t> & left, const FlatMap<key_t, data_t> & right)
+    template <typename key_t, typename data_t, typename container_t>
+    bool operator!=(
+        const FlatMap<key_t, data_t, container_t> & left,
+        const FlatMap<key_t, data_t, container_t> & right)
     {
         return !(left == right);
     }
 
-    template <typename key_t, typename data_t>
-    bool operator<(const FlatMap<key_t, data_t> & left, const FlatMap<key_t, data_t> & right)
+    // Lexicographic over the entries as if both maps were sorted, so unlike operator== this
+    // needs operator< for the data too, just like comparing two std::pairs.  Maps not already
+    // sorted are sorted as a view of pointers, which allocates for maps over 32 entries.
+    template <typename key_t, typename data_t, typename container_t>
+    bool operator<(
+        const FlatMap<key_t, data_t, container_t> & left,
+        const FlatMap<key_t, data_t, container_t> & right)
     {
-        typename FlatMap<key_t, data_t>::container_t leftVec{ left.m_vector };
-        typename FlatMap<key_t, data_t>::container_t rightVec{ right.m_vector };
+        if (std::is_sorted(std::begin(left), std::end(left)) &&
+            std::is_sorted(std::begin(right), std::end(right)))
+        {
+            return std::lexicographical_compare(
+                std::begin(left), std::end(left), std::begin(right), std::end(right));
+        }
+
+        const auto pairLess{ [](const auto & leftPair, const auto & rightPair) {
+            return (leftPair < rightPair);
+        } };
 
-        std::sort(std::begin(leftVec), std::end(leftVec));
-        std::sort(std::begin(leftVec), std::end(leftVec));
+        using map_t = FlatMap<key_t, data_t, container_t>;
+        const auto leftView{ map_t::sortedView(std::begin(left), std::end(left), pairLess) };
+        const auto rightView{ map_t::sortedView(std::begin(right), std::end(right), pairLess) };
 
-        return (leftVec < rightVec);
+        return std::lexicographical_compare(
+            std::begin(leftView),
+            std::end(leftView),
+            std::begin(rightView),
+            std::end(rightView),
+            [](const auto * leftPair, const auto * rightPair) { return (*leftPair < *rightPair); });
     }
 
-    template <typename key_t, typename data_t>
-    bool operator>(const FlatMap<key_t, data_t> & left, const FlatMap<key_t, data_t> & right)
+    template <typename key_t, typename data_t, typename container_t>
+    bool operator>(
+        const FlatMap<key_t, data_t, container_t> & left,
+        const FlatMap<key_t, data_t, container_t> & right)
     {
         return (right < left);
     }
 
-    template <typename key_t, typename data_t>
-    bool operator<=(const FlatMap<key_t, data_t> & left, const FlatMap<key_t, data_t> & right)
+    template <typename key_t, typename data_t, typename container_t>
+    bool operator<=(
+        const FlatMap<key_t, data_t, container_t> & left,
+        const FlatMap<key_t, data_t, container_t> & right)
     {
         return !(left > right);
     }
 
-    template <typename key_t, typename data_t>
-    bool operator>=(const FlatMap<key_t, data_t> & left, const FlatMap<key_t, data_t> & right)
+    template <typename key_t, typename data_t, typename container_t>
+    bool operator>=(
+        const FlatMap<key_t, data_t, container_t> & left,
+        const FlatMap<key_t, data_t, container_t> & right)
     {
         return !(left < right);
     }
 
+    template <typename key_t, typename data_t, typename container_t>
+    void swap(
+        FlatMap<key_t, data_t, container_t> & left,
+        FlatMap<key_t, data_t, container_t> & right) noexcept(noexcept(left.swap(right)))
+    {
+        left.swap(right);
+    }
+
+    // What changed from before to after, see FlatMapDiff.  Works like FlatMap::merge(), so it is
+    // one linear walk if both maps are already sorted by key.  data_t needs operator==.
+    template <typename key_t, typename data_t, typename container_t, typename container2_t>
+    FlatMapDiff<key_t, data_t> diff(
+        const FlatMap<key_t, data_t, container_t> & before,
+        const FlatMap<key_t, data_t, container2_t> & after)
+    {
+        using map_t = FlatMap<key_t, data_t, container_t>;
+
+        const typename map_t::key_order_t beforeOrder{ map_t::keyOrder(before, true) };
+        const typename map_t::key_order_t afterOrder{ map_t::keyOrder(after, true) };
+
+        const auto beforeFirst{ std::begin(before) };
+        const auto afterFirst{ std::begin(after) };
+
+        FlatMapDiff<key_t, data_t> result;
+
+        auto beforeIter{ std::begin(beforeOrder) };
+        auto afterIter{ std::begin(afterOrder) };
+
+        while ((beforeIter != std::end(beforeOrder)) || (afterIter != std::end(afterOrder)))
+        {
+            if (afterIter == std::end(afterOrder))
+            {
+                result.removed.push_back(beforeFirst[static_cast<std::ptrdiff_t>(*beforeIter++)]);
+                continue;
+            }
+
+            if (beforeIter == std::end(beforeOrder))
+            {
+                result.added.push_back(afterFirst[static_cast<std::ptrdiff_t>(*afterIter++)]);
+                continue;
+            }
+
+            const auto & beforePair{ beforeFirst[static_cast<std::ptrdiff_t>(*beforeIter)] };
+            const auto & afterPair{ afterFirst[static_cast<std::ptrdiff_t>(*afterIter)] };
+
+            if (beforePair.first < afterPair.first)
+            {
+                result.removed.push_back(beforePair);
+                ++beforeIter;
+            }
+            else if (afterPair.first < beforePair.first)
+            {
+                result.added.push_back(afterPair);
+                ++afterIter;
+            }
+            else
+            {
+                if (!(beforePair.second == afterPair.second))
+                {
+                    result.changed.push_back(afterPair);
+                }
+
+                ++beforeIter;
+                ++afterIter;
+            }
+        }
+
+        return result;
+    }
+
+    // A FlatMap that holds up to inline_capacity entries inside itself before allocating.
+    template <typename key_t, typename data_t, std::size_t inline_capacity>
+    using SmallFlatMap =
+        FlatMap<key_t, data_t, SmallVector<std::pair<key_t, data_t>, inline_capacity>>;
+
     //
 
-    template <typename key_t, typename data_t>
-    constexpr auto begin(FlatMap<key_t, data_t> & map) noexcept
+    template <typename key_t, typename data_t, typename container_t>
+    constexpr auto begin(FlatMap<key_t, data_t, container_t> & map) noexcept
     {
         return map.begin();
     }
 
-    template <typename key_t, typename data_t>
-    constexpr auto begin(const FlatMap<key_t, data_t> & map) noexcept
+    template <typename key_t, typename data_t, typename container_t>
+    constexpr auto begin(const FlatMap<key_t, data_t, container_t> & map) noexcept
     {
         return map.begin();
     }
 
-    template <typename key_t, typename data_t>
-    constexpr auto cbegin(const FlatMap<key_t, data_t> & map) noexcept
+    template <typename key_t, typename data_t, typename container_t>
+    constexpr auto cbegin(const FlatMap<key_t, data_t, container_t> & map) noexcept
     {
         return begin(map);
     }
 
-    template <typename key_t, typename data_t>
-    constexpr auto rbegin(FlatMap<key_t, data_t> & map) noexcept
+    template <typename key_t, typename data_t, typename container_t>
+    constexpr auto rbegin(FlatMap<key_t, data_t, container_t> & map) noexcept
     {
         return map.rbegin();
     }
 
-    template <typename key_t, typename data_t>
-    constexpr auto rbegin(const FlatMap<key_t, data_t> & map) noexcept
+    template <typename key_t, typename data_t, typename container_t>
+    constexpr auto rbegin(const FlatMap<key_t, data_t, container_t> & map) noexcept
     {
         return map.rbegin();
     }
 
-    template <typename key_t, typename data_t>
-    constexpr auto crbegin(const FlatMap<key_t, data_t> & map) noexcept
+    template <typename key_t, typename data_t, typename container_t>
+    constexpr auto crbegin(const FlatMap<key_t, data_t, container_t> & map) noexcept
     {
         return rbegin(map);
     }
 
-    template <typename key_t, typename data_t>
-    constexpr auto end(FlatMap<key_t, data_t> & map) noexcept
+    template <typename key_t, typename data_t, typename container_t>
+    constexpr auto end(FlatMap<key_t, data_t, container_t> & map) noexcept
     {
         return map.end();
     }
 
-    template <typename key_t, typename data_t>
-    constexpr auto end(const FlatMap<key_t, data_t> & map) noexcept
+    template <typename key_t, typename data_t, typename container_t>
+    constexpr auto end(const FlatMap<key_t, data_t, container_t> & map) noexcept
     {
         return map.end();
     }
 
-    template <typename key_t, typename data_t>
-    constexpr auto cend(const FlatMap<key_t, data_t> & map) noexcept
+    template <typename key_t, typename data_t, typename container_t>
+    constexpr auto cend(const FlatMap<key_t, data_t, container_t> & map) noexcept
     {
         return end(map);
     }
 
-    template <typename key_t, typename data_t>
-    constexpr auto rend(FlatMap<key_t, data_t> & map) noexcept
+    template <typename key_t, typename data_t, typename container_t>
+    constexpr auto rend(FlatMap<key_t, data_t, container_t> & map) noexcept
     {
         return map.rend();
     }
 
-    template <typename key_t, typename data_t>
-    constexpr auto rend(const FlatMap<key_t, data_t> & map) noexcept
+    template <typename key_t, typename data_t, typename container_t>
+    constexpr auto rend(const FlatMap<key_t, data_t, container_t> & map) noexcept
     {
         return map.rend();
     }
 
-    template <typename key_t, typename data_t>
-    constexpr auto crend(const FlatMap<key_t, data_t> & map) noexcept
+    template <typename key_t, typename data_t, typename container_t>
+    constexpr auto crend(const FlatMap<key_t, data_t, container_t> & map) noexcept
     {
         return rend(map);
     }
 
+#if __has_include(<memory_resource>)
+    namespace pmr
+    {
+
+        // A FlatMap that allocates from a std::pmr::memory_resource, such as an arena that can
+        // release everything at once instead of destroying and freeing every map on its own.
+        template <typename key_t, typename data_t>
+        using FlatMap = utilz::FlatMap<key_t, data_t, std::pmr::vector<std::pair<key_t, data_t>>>;
+
+    } // namespace pmr
+#endif
+
 } // namespace utilz
 
 #endif // FLAT_MAP_HPP_INCLUDED
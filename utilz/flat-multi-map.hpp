@@ -0,0 +1,436 @@
+#ifndef FLAT_MULTI_MAP_HPP_INCLUDED
+#define FLAT_MULTI_MAP_HPP_INCLUDED
+//
+// flat-multi-map.hpp
+//
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace utilz
+{
+
+    // A FlatMap where duplicate keys are the point instead of an accident.  The vector is always
+    // sorted by key, so all the entries of a key sit together, in the order they were inserted.
+    // That makes equalRange() and count() binary searches, and groups() visits each key once
+    // along with all of its entries.
+    //
+    // insert() is O(n) because of the shift, so use insertRange() to add many at once.
+    // Changing keys through iterators will break the sort order, so don't.
+    template <typename key_t, typename data_t>
+    class FlatMultiMap
+    {
+      public:
+        using value_t = std::pair<key_t, data_t>;
+        using container_t = std::vector<value_t>;
+        using iterator_t = typename container_t::iterator;
+        using const_iterator_t = typename container_t::const_iterator;
+        using reverse_iterator_t = std::reverse_iterator<iterator_t>;
+        using const_reverse_iterator_t = std::reverse_iterator<const_iterator_t>;
+
+        // all the entries of one key, which can be iterated over with range-for
+        template <typename iter_t>
+        struct Group
+        {
+            const key_t & key() const { return first->first; }
+            std::size_t size() const { return static_cast<std::size_t>(last - first); }
+
+            iter_t begin() const { return first; }
+            iter_t end() const { return last; }
+
+            iter_t first;
+            iter_t last;
+        };
+
+        // visits the first entry of each key, and yields the Group of entries with that key
+        template <typename iter_t>
+        class GroupIterator
+        {
+          public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Group<iter_t>;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const value_type *;
+            using reference = const value_type &;
+
+            GroupIterator() = default;
+
+            GroupIterator(const iter_t first, const iter_t last)
+                : m_group{ first, first }
+                , m_last(last)
+            {
+                findGroupEnd();
+            }
+
+            reference operator*() const { return m_group; }
+            pointer operator->() const { return &m_group; }
+
+            GroupIterator & operator++()
+            {
+                m_group.first = m_group.last;
+                findGroupEnd();
+                return *this;
+            }
+
+            GroupIterator operator++(int)
+            {
+                GroupIterator before{ *this };
+                ++(*this);
+                return before;
+            }
+
+            bool operator==(const GroupIterator & other) const
+            {
+                return (m_group.first == other.m_group.first);
+            }
+
+            bool operator!=(const GroupIterator & other) const { return !(*this == other); }
+
+          private:
+            // a linear walk instead of upper_bound, so visiting every group is O(n) overall
+            void findGroupEnd()
+            {
+                m_group.last = m_group.first;
+
+                if (m_group.first == m_last)
+                {
+                    return;
+                }
+
+                const key_t & key{ m_group.first->first };
+                while ((m_group.last != m_last) && !(key < m_group.last->first))
+                {
+                    ++m_group.last;
+                }
+            }
+
+          private:
+            Group<iter_t> m_group;
+            iter_t m_last;
+        };
+
+        template <typename iter_t>
+        struct GroupRange
+        {
+            GroupIterator<iter_t> begin() const { return GroupIterator<iter_t>(first, last); }
+            GroupIterator<iter_t> end() const { return GroupIterator<iter_t>(last, last); }
+
+            iter_t first;
+            iter_t last;
+        };
+
+        FlatMultiMap()
+            : m_vector()
+        {}
+
+        FlatMultiMap(const FlatMultiMap &) = default;
+        FlatMultiMap(FlatMultiMap &&) = default;
+
+        FlatMultiMap & operator=(const FlatMultiMap &) = default;
+        FlatMultiMap & operator=(FlatMultiMap &&) = default;
+
+        bool empty() const noexcept { return m_vector.empty(); }
+        std::size_t size() const noexcept { return m_vector.size(); }
+        void clear() noexcept { m_vector.clear(); }
+
+        void reserve(const std::size_t count) { m_vector.reserve(count); }
+        std::size_t capacity() const noexcept { return m_vector.capacity(); }
+        void shrinkToFit() { m_vector.shrink_to_fit(); }
+
+        // always adds, after any entries that already have this key
+        iterator_t insert(const key_t & key, const data_t & data)
+        {
+            return m_vector.insert(upperBound(key), value_t(key, data));
+        }
+
+        iterator_t insert(const value_t & pair) { return insert(pair.first, pair.second); }
+
+        // Appends everything, sorts only what was added, and then merges the two, which is
+        // O(n + k log k) instead of the O(n * k) of one insert() each.  Entries with the same key
+        // keep the order they were in, after the entries that were already in the map.
+        template <typename Iter_t>
+        void insertRange(const Iter_t first, const Iter_t last)
+        {
+            const std::size_t sizeBefore{ m_vector.size() };
+            m_vector.insert(std::end(m_vector), first, last);
+
+            const iterator_t middle{ std::begin(m_vector) +
+                                     static_cast<std::ptrdiff_t>(sizeBefore) };
+
+            std::stable_sort(middle, std::end(m_vector), KeyLess());
+            std::inplace_merge(std::begin(m_vector), middle, std::end(m_vector), KeyLess());
+        }
+
+        // erases all entries with this key and returns how many that was
+        std::size_t erase(const key_t & key)
+        {
+            const auto [first, last] = equalRange(key);
+            const std::size_t count{ static_cast<std::size_t>(last - first) };
+            m_vector.erase(first, last);
+            return count;
+        }
+
+        iterator_t erase(const const_iterator_t & iter) { return m_vector.erase(iter); }
+
+        iterator_t erase(const const_iterator_t & from, const const_iterator_t & to)
+        {
+            return m_vector.erase(from, to);
+        }
+
+        // all the entries with this key, empty if there are none
+        std::pair<iterator_t, iterator_t> equalRange(const key_t & key)
+        {
+            return std::equal_range(std::begin(m_vector), std::end(m_vector), key, KeyLess());
+        }
+
+        std::pair<const_iterator_t, const_iterator_t> equalRange(const key_t & key) const
+        {
+            return std::equal_range(std::begin(m_vector), std::end(m_vector), key, KeyLess());
+        }
+
+        std::size_t count(const key_t & key) const
+        {
+            const auto [first, last] = equalRange(key);
+            return static_cast<std::size_t>(last - first);
+        }
+
+        bool exists(const key_t & key) const
+        {
+            const const_iterator_t iter{ lowerBound(key) };
+            return ((iter != std::end(m_vector)) && !(key < iter->first));
+        }
+
+        // the first entry inserted with this key
+        iterator_t find(const key_t & key)
+        {
+            const iterator_t iter{ lowerBound(key) };
+
+            if ((iter != std::end(m_vector)) && !(key < iter->first))
+            {
+                return iter;
+            }
+
+            return std::end(m_vector);
+        }
+
+        const_iterator_t find(const key_t & key) const
+        {
+            const const_iterator_t iter{ lowerBound(key) };
+
+            if ((iter != std::end(m_vector)) && !(key < iter->first))
+            {
+                return iter;
+            }
+
+            return std::end(m_vector);
+        }
+
+        iterator_t lowerBound(const key_t & key)
+        {
+            return std::lower_bound(std::begin(m_vector), std::end(m_vector), key, KeyLess());
+        }
+
+        const_iterator_t lowerBound(const key_t & key) const
+        {
+            return std::lower_bound(std::begin(m_vector), std::end(m_vector), key, KeyLess());
+        }
+
+        iterator_t upperBound(const key_t & key)
+        {
+            return std::upper_bound(std::begin(m_vector), std::end(m_vector), key, KeyLess());
+        }
+
+        const_iterator_t upperBound(const key_t & key) const
+        {
+            return std::upper_bound(std::begin(m_vector), std::end(m_vector), key, KeyLess());
+        }
+
+        // for (const auto & group : map.groups()) { group.key(); group.size(); for (pair : group) }
+        GroupRange<iterator_t> groups() { return { std::begin(m_vector), std::end(m_vector) }; }
+
+        GroupRange<const_iterator_t> groups() const
+        {
+            return { std::begin(m_vector), std::end(m_vector) };
+        }
+
+        // the number of different keys
+        std::size_t groupCount() const
+        {
+            const GroupRange<const_iterator_t> range{ groups() };
+            return static_cast<std::size_t>(std::distance(range.begin(), range.end()));
+        }
+
+        constexpr iterator_t begin() noexcept { return std::begin(m_vector); }
+        constexpr iterator_t end() noexcept { return std::end(m_vector); }
+
+        constexpr const_iterator_t begin() const noexcept { return std::begin(m_vector); }
+        constexpr const_iterator_t end() const noexcept { return std::end(m_vector); }
+
+        constexpr const_iterator_t cbegin() const noexcept { return begin(); }
+        constexpr const_iterator_t cend() const noexcept { return end(); }
+
+        constexpr reverse_iterator_t rbegin() noexcept { return reverse_iterator_t(end()); }
+        constexpr reverse_iterator_t rend() noexcept { return reverse_iterator_t(begin()); }
+
+        constexpr const_reverse_iterator_t rbegin() const noexcept
+        {
+            return const_reverse_iterator_t(end());
+        }
+
+        constexpr const_reverse_iterator_t rend() const noexcept
+        {
+            return const_reverse_iterator_t(begin());
+        }
+
+        constexpr const_reverse_iterator_t crbegin() const noexcept { return rbegin(); }
+        constexpr const_reverse_iterator_t crend() const noexcept { return rend(); }
+
+      private:
+        // compares keys only, so values never need operator<
+        struct KeyLess
+        {
+            bool operator()(const value_t & left, const value_t & right) const
+            {
+                return (left.first < right.first);
+            }
+
+            bool operator()(const value_t & pair, const key_t & key) const
+            {
+                return (pair.first < key);
+            }
+
+            bool operator()(const key_t & key, const value_t & pair) const
+            {
+                return (key < pair.first);
+            }
+        };
+
+      private:
+        container_t m_vector;
+    };
+
+    //
+
+    // like std::multimap, entries with the same key are compared in the order they were inserted
+    template <typename key_t, typename data_t>
+    bool operator==(
+        const FlatMultiMap<key_t, data_t> & left, const FlatMultiMap<key_t, data_t> & right)
+    {
+        return std::equal(std::begin(left), std::end(left), std::begin(right), std::end(right));
+    }
+
+    template <typename key_t, typename data_t>
+    bool operator!=(
+        const FlatMultiMap<key_t, data_t> & left, const FlatMultiMap<key_t, data_t> & right)
+    {
+        return !(left == right);
+    }
+
+    template <typename key_t, typename data_t>
+    bool operator<(
+        const FlatMultiMap<key_t, data_t> & left, const FlatMultiMap<key_t, data_t> & right)
+    {
+        return std::lexicographical_compare(
+            std::begin(left), std::end(left), std::begin(right), std::end(right));
+    }
+
+    template <typename key_t, typename data_t>
+    bool operator>(
+        const FlatMultiMap<key_t, data_t> & left, const FlatMultiMap<key_t, data_t> & right)
+    {
+        return (right < left);
+    }
+
+    template <typename key_t, typename data_t>
+    bool operator<=(
+        const FlatMultiMap<key_t, data_t> & left, const FlatMultiMap<key_t, data_t> & right)
+    {
+        return !(left > right);
+    }
+
+    template <typename key_t, typename data_t>
+    bool operator>=(
+        const FlatMultiMap<key_t, data_t> & left, const FlatMultiMap<key_t, data_t> & right)
+    {
+        return !(left < right);
+    }
+
+    //
+
+    template <typename key_t, typename data_t>
+    constexpr auto begin(FlatMultiMap<key_t, data_t> & map) noexcept
+    {
+        return map.begin();
+    }
+
+    template <typename key_t, typename data_t>
+    constexpr auto begin(const FlatMultiMap<key_t, data_t> & map) noexcept
+    {
+        return map.begin();
+    }
+
+    template <typename key_t, typename data_t>
+    constexpr auto cbegin(const FlatMultiMap<key_t, data_t> & map) noexcept
+    {
+        return map.cbegin();
+    }
+
+    template <typename key_t, typename data_t>
+    constexpr auto rbegin(FlatMultiMap<key_t, data_t> & map) noexcept
+    {
+        return map.rbegin();
+    }
+
+    template <typename key_t, typename data_t>
+    constexpr auto rbegin(const FlatMultiMap<key_t, data_t> & map) noexcept
+    {
+        return map.rbegin();
+    }
+
+    template <typename key_t, typename data_t>
+    constexpr auto crbegin(const FlatMultiMap<key_t, data_t> & map) noexcept
+    {
+        return map.crbegin();
+    }
+
+    template <typename key_t, typename data_t>
+    constexpr auto end(FlatMultiMap<key_t, data_t> & map) noexcept
+    {
+        return map.end();
+    }
+
+    template <typename key_t, typename data_t>
+    constexpr auto end(const FlatMultiMap<key_t, data_t> & map) noexcept
+    {
+        return map.end();
+    }
+
+    template <typename key_t, typename data_t>
+    constexpr auto cend(const FlatMultiMap<key_t, data_t> & map) noexcept
+    {
+        return map.cend();
+    }
+
+    template <typename key_t, typename data_t>
+    constexpr auto rend(FlatMultiMap<key_t, data_t> & map) noexcept
+    {
+        return map.rend();
+    }
+
+    template <typename key_t, typename data_t>
+    constexpr auto rend(const FlatMultiMap<key_t, data_t> & map) noexcept
+    {
+        return map.rend();
+    }
+
+    template <typename key_t, typename data_t>
+    constexpr auto crend(const FlatMultiMap<key_t, data_t> & map) noexcept
+    {
+        return map.crend();
+    }
+
+} // namespace utilz
+
+#endif // FLAT_MULTI_MAP_HPP_INCLUDED
@@ -0,0 +1,804 @@
+#ifndef FLAT_SET_HPP_INCLUDED
+#define FLAT_SET_HPP_INCLUDED
+//
+// flat-set.hpp
+//
+#include "utilz/hashed-flat-map.hpp"
+#include "utilz/small-vector.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
+
+namespace utilz
+{
+
+    // What a FlatMap<key_t, bool> was always trying to be, a vector of just the keys.
+    // Any vector-like container of keys can be used instead of std::vector, see SmallFlatSet.
+    //
+    // insert() keeps the keys unique, and sorted if they already were, which they are from the
+    // start.  So a set that is only ever insert()'ed to is always sorted and lookups are binary
+    // searches.  append() is for bulk loads, it just pushes to the back (duplicates and all) and
+    // makes lookups linear until the next sortAndUnique().
+    //
+    // unionWith(), intersectWith(), and difference() are linear merges of two sorted sets.  If
+    // this set is not sorted it is sorted first, and if the other is not then a sorted copy of its
+    // keys is merged instead, so they are only O(n + m) when both are sorted.
+    //
+    // Changing keys through iterators will break the sort order, so don't.  For O(1) expected
+    // lookups of sets too big to binary search quickly, see HashedFlatSet below.
+    template <typename key_t, typename storage_t = std::vector<key_t>>
+    class FlatSet
+    {
+      public:
+        using value_t = key_t;
+        using container_t = storage_t;
+        using iterator_t = typename container_t::iterator;
+        using const_iterator_t = typename container_t::const_iterator;
+        using reverse_iterator_t = std::reverse_iterator<iterator_t>;
+        using const_reverse_iterator_t = std::reverse_iterator<const_iterator_t>;
+
+        FlatSet()
+            : m_vector()
+            , m_isSorted(true)
+        {}
+
+        // the allocator-extended constructor, only for containers that take an allocator
+        template <
+            typename alloc_t,
+            typename = std::enable_if_t<std::uses_allocator_v<container_t, alloc_t>>>
+        explicit FlatSet(const alloc_t & allocator)
+            : m_vector(allocator)
+            , m_isSorted(true)
+        {}
+
+        FlatSet(const FlatSet &) = default;
+        FlatSet(FlatSet &&) = default;
+
+        FlatSet & operator=(const FlatSet &) = default;
+        FlatSet & operator=(FlatSet &&) = default;
+
+        void swap(FlatSet & other) noexcept(std::is_nothrow_swappable_v<container_t>)
+        {
+            using std::swap;
+            swap(m_vector, other.m_vector);
+            swap(m_isSorted, other.m_isSorted);
+        }
+
+        bool empty() const noexcept { return m_vector.empty(); }
+        std::size_t size() const noexcept { return m_vector.size(); }
+
+        void clear() noexcept
+        {
+            m_vector.clear();
+            m_isSorted = true;
+        }
+
+        void reserve(const std::size_t count) { m_vector.reserve(count); }
+        std::size_t capacity() const noexcept { return m_vector.capacity(); }
+        void shrinkToFit() { m_vector.shrink_to_fit(); }
+
+        // true if nothing has been append()'ed since the last sortAndUnique()
+        bool isSorted() const noexcept { return m_isSorted; }
+
+        // does nothing if the key exists, returns (iter, was_inserted)
+        std::pair<iterator_t, bool> insert(const key_t & key) { return insertImpl(key); }
+        std::pair<iterator_t, bool> insert(key_t && key) { return insertImpl(std::move(key)); }
+
+        // duplicate keys maintained, see sortAndUnique()
+        void append(const key_t & key) { appendImpl(key); }
+        void append(key_t && key) { appendImpl(std::move(key)); }
+
+        // appends everything and then calls sortAndUnique() once
+        template <typename Iter_t>
+        void insertRange(const Iter_t first, const Iter_t last)
+        {
+            for (Iter_t iter(first); iter != last; ++iter)
+            {
+                m_vector.push_back(*iter);
+            }
+
+            m_isSorted = false;
+            sortAndUnique();
+        }
+
+        // returns how many keys were erased, which can be more than one after append()
+        std::size_t erase(const key_t & key)
+        {
+            const std::size_t sizeBefore{ m_vector.size() };
+
+            if (m_isSorted)
+            {
+                const auto [first, last] =
+                    std::equal_range(std::begin(m_vector), std::end(m_vector), key);
+
+                m_vector.erase(first, last);
+            }
+            else
+            {
+                m_vector.erase(
+                    std::remove(std::begin(m_vector), std::end(m_vector), key), std::end(m_vector));
+            }
+
+            return (sizeBefore - m_vector.size());
+        }
+
+        iterator_t erase(const const_iterator_t & iter) { return m_vector.erase(iter); }
+
+        iterator_t erase(const const_iterator_t & from, const const_iterator_t & to)
+        {
+            return m_vector.erase(from, to);
+        }
+
+        iterator_t find(const key_t & key) { return findImpl(*this, key); }
+        const_iterator_t find(const key_t & key) const { return findImpl(*this, key); }
+
+        bool exists(const key_t & key) const { return (find(key) != std::end(m_vector)); }
+
+        void sortAndUnique()
+        {
+            if (m_isSorted)
+            {
+                return;
+            }
+
+            std::sort(std::begin(m_vector), std::end(m_vector));
+
+            m_vector.erase(
+                std::unique(std::begin(m_vector), std::end(m_vector)), std::end(m_vector));
+
+            m_isSorted = true;
+        }
+
+        // adds every key in other that is not already in this set
+        template <typename other_storage_t>
+        void unionWith(const FlatSet<key_t, other_storage_t> & other)
+        {
+            sortAndUnique();
+
+            if constexpr (std::is_same_v<other_storage_t, storage_t>)
+            {
+                if (&other == this)
+                {
+                    return;
+                }
+            }
+
+            withSortedKeys(other, [&](const auto first, const auto last) {
+                const std::size_t sizeBefore{ m_vector.size() };
+
+                // only the keys that are missing are appended, and they are already sorted
+                std::size_t index{ 0 };
+                for (auto otherIter(first); otherIter != last; ++otherIter)
+                {
+                    while ((index < sizeBefore) && (m_vector[index] < *otherIter))
+                    {
+                        ++index;
+                    }
+
+                    if ((index == sizeBefore) || (*otherIter < m_vector[index]))
+                    {
+                        m_vector.push_back(*otherIter);
+                    }
+                }
+
+                std::inplace_merge(
+                    std::begin(m_vector),
+                    std::next(std::begin(m_vector), static_cast<std::ptrdiff_t>(sizeBefore)),
+                    std::end(m_vector));
+            });
+        }
+
+        // erases every key that is not also in other
+        template <typename other_storage_t>
+        void intersectWith(const FlatSet<key_t, other_storage_t> & other)
+        {
+            sortAndUnique();
+
+            withSortedKeys(other, [&](const auto first, const auto last) {
+                keepIf(first, last, true);
+            });
+        }
+
+        // erases every key that is also in other
+        template <typename other_storage_t>
+        void difference(const FlatSet<key_t, other_storage_t> & other)
+        {
+            sortAndUnique();
+
+            withSortedKeys(other, [&](const auto first, const auto last) {
+                keepIf(first, last, false);
+            });
+        }
+
+        constexpr iterator_t begin() noexcept { return std::begin(m_vector); }
+        constexpr iterator_t end() noexcept { return std::end(m_vector); }
+
+        constexpr const_iterator_t begin() const noexcept { return std::begin(m_vector); }
+        constexpr const_iterator_t end() const noexcept { return std::end(m_vector); }
+
+        constexpr const_iterator_t cbegin() const noexcept { return begin(); }
+        constexpr const_iterator_t cend() const noexcept { return end(); }
+
+        constexpr reverse_iterator_t rbegin() noexcept { return reverse_iterator_t(end()); }
+        constexpr reverse_iterator_t rend() noexcept { return reverse_iterator_t(begin()); }
+
+        constexpr const_reverse_iterator_t rbegin() const noexcept
+        {
+            return const_reverse_iterator_t(end());
+        }
+
+        constexpr const_reverse_iterator_t rend() const noexcept
+        {
+            return const_reverse_iterator_t(begin());
+        }
+
+        constexpr const_reverse_iterator_t crbegin() const noexcept { return rbegin(); }
+        constexpr const_reverse_iterator_t crend() const noexcept { return rend(); }
+
+        // clang-format off
+        template<typename T, typename C>
+        friend bool operator==(const FlatSet<T, C> & left, const FlatSet<T, C> & right);
+        // clang-format on
+
+      private:
+        // Calls func(first, last) with the keys of set sorted and unique, which are the set's own
+        // iterators if it is sorted, otherwise those of a sorted copy.
+        template <typename set_t, typename Func_t>
+        static void withSortedKeys(const set_t & set, Func_t func)
+        {
+            if (set.isSorted())
+            {
+                func(std::begin(set), std::end(set));
+                return;
+            }
+
+            std::vector<key_t> keys(std::begin(set), std::end(set));
+            std::sort(std::begin(keys), std::end(keys));
+            keys.erase(std::unique(std::begin(keys), std::end(keys)), std::end(keys));
+
+            func(std::cbegin(keys), std::cend(keys));
+        }
+
+        // one version for both const and non-const sets
+        template <typename set_t>
+        static auto findImpl(set_t & set, const key_t & key)
+        {
+            if (set.m_isSorted)
+            {
+                const auto iter{ std::lower_bound(
+                    std::begin(set.m_vector), std::end(set.m_vector), key) };
+
+                if ((iter != std::end(set.m_vector)) && !(key < *iter))
+                {
+                    return iter;
+                }
+
+                return std::end(set.m_vector);
+            }
+
+            return std::find(std::begin(set.m_vector), std::end(set.m_vector), key);
+        }
+
+        // stays sorted as long as the keys are appended in order
+        template <typename K>
+        void appendImpl(K && key)
+        {
+            m_isSorted = (m_isSorted && (m_vector.empty() || (m_vector.back() < key)));
+            m_vector.push_back(std::forward<K>(key));
+        }
+
+        template <typename K>
+        std::pair<iterator_t, bool> insertImpl(K && key)
+        {
+            if (m_isSorted)
+            {
+                const iterator_t iter{ std::lower_bound(
+                    std::begin(m_vector), std::end(m_vector), key) };
+
+                if ((iter != std::end(m_vector)) && !(key < *iter))
+                {
+                    return { iter, false };
+                }
+
+                return { m_vector.insert(iter, std::forward<K>(key)), true };
+            }
+
+            const iterator_t iter{ std::find(std::begin(m_vector), std::end(m_vector), key) };
+            if (iter != std::end(m_vector))
+            {
+                return { iter, false };
+            }
+
+            m_vector.push_back(std::forward<K>(key));
+            return { std::prev(std::end(m_vector)), true };
+        }
+
+        // one pass over both sorted ranges that keeps each key if (is in [first, last)) == keep
+        template <typename Iter_t>
+        void keepIf(const Iter_t first, const Iter_t last, const bool keep)
+        {
+            Iter_t otherIter{ first };
+            iterator_t kept{ std::begin(m_vector) };
+
+            for (iterator_t iter(std::begin(m_vector)); iter != std::end(m_vector); ++iter)
+            {
+                while ((otherIter != last) && (*otherIter < *iter))
+                {
+                    ++otherIter;
+                }
+
+                const bool isInOther{ (otherIter != last) && !(*iter < *otherIter) };
+                if (isInOther != keep)
+                {
+                    continue;
+                }
+
+                if (kept != iter)
+                {
+                    *kept = std::move(*iter);
+                }
+
+                ++kept;
+            }
+
+            m_vector.erase(kept, std::end(m_vector));
+        }
+
+      private:
+        container_t m_vector;
+        bool m_isSorted;
+    };
+
+    //
+
+    // sets are compared as sets, so the order keys were appended in does not matter
+    template <typename key_t, typename storage_t>
+    bool operator==(
+        const FlatSet<key_t, storage_t> & left, const FlatSet<key_t, storage_t> & right)
+    {
+        using set_t = FlatSet<key_t, storage_t>;
+        bool isEqual{ false };
+
+        set_t::withSortedKeys(left, [&](const auto leftFirst, const auto leftLast) {
+            set_t::withSortedKeys(right, [&](const auto rightFirst, const auto rightLast) {
+                isEqual = std::equal(leftFirst, leftLast, rightFirst, rightLast);
+            });
+        });
+
+        return isEqual;
+    }
+
+    template <typename key_t, typename storage_t>
+    bool operator!=(
+        const FlatSet<key_t, storage_t> & left, const FlatSet<key_t, storage_t> & right)
+    {
+        return !(left == right);
+    }
+
+    template <typename key_t, typename storage_t>
+    void swap(FlatSet<key_t, storage_t> & left, FlatSet<key_t, storage_t> & right) noexcept(
+        noexcept(left.swap(right)))
+    {
+        left.swap(right);
+    }
+
+    // A FlatSet that holds up to inline_capacity keys inside itself before allocating.
+    template <typename key_t, std::size_t inline_capacity>
+    using SmallFlatSet = FlatSet<key_t, SmallVector<key_t, inline_capacity>>;
+
+    //
+
+    template <typename key_t, typename storage_t>
+    constexpr auto begin(FlatSet<key_t, storage_t> & set) noexcept
+    {
+        return set.begin();
+    }
+
+    template <typename key_t, typename storage_t>
+    constexpr auto begin(const FlatSet<key_t, storage_t> & set) noexcept
+    {
+        return set.begin();
+    }
+
+    template <typename key_t, typename storage_t>
+    constexpr auto cbegin(const FlatSet<key_t, storage_t> & set) noexcept
+    {
+        return begin(set);
+    }
+
+    template <typename key_t, typename storage_t>
+    constexpr auto rbegin(FlatSet<key_t, storage_t> & set) noexcept
+    {
+        return set.rbegin();
+    }
+
+    template <typename key_t, typename storage_t>
+    constexpr auto rbegin(const FlatSet<key_t, storage_t> & set) noexcept
+    {
+        return set.rbegin();
+    }
+
+    template <typename key_t, typename storage_t>
+    constexpr auto crbegin(const FlatSet<key_t, storage_t> & set) noexcept
+    {
+        return rbegin(set);
+    }
+
+    template <typename key_t, typename storage_t>
+    constexpr auto end(FlatSet<key_t, storage_t> & set) noexcept
+    {
+        return set.end();
+    }
+
+    template <typename key_t, typename storage_t>
+    constexpr auto end(const FlatSet<key_t, storage_t> & set) noexcept
+    {
+        return set.end();
+    }
+
+    template <typename key_t, typename storage_t>
+    constexpr auto cend(const FlatSet<key_t, storage_t> & set) noexcept
+    {
+        return end(set);
+    }
+
+    template <typename key_t, typename storage_t>
+    constexpr auto rend(FlatSet<key_t, storage_t> & set) noexcept
+    {
+        return set.rend();
+    }
+
+    template <typename key_t, typename storage_t>
+    constexpr auto rend(const FlatSet<key_t, storage_t> & set) noexcept
+    {
+        return set.rend();
+    }
+
+    template <typename key_t, typename storage_t>
+    constexpr auto crend(const FlatSet<key_t, storage_t> & set) noexcept
+    {
+        return rend(set);
+    }
+
+    //
+
+    // A FlatSet with the same hashed index as HashedFlatMap on the side, so lookups are O(1)
+    // expected while iterating is still a plain walk over a vector of just the keys, in the order
+    // they were inserted.  Each key is only ever in here once.  Erasing shifts the vector so it
+    // rebuilds the index, which is O(n) just like HashedFlatMap.
+    //
+    // unionWith(), intersectWith(), and difference() look up each key in the other set instead of
+    // merging, so they are O(n + m) expected without sorting anything, and keep this set's order.
+    //
+    // Changing keys through iterators will break the index, so don't.
+    template <typename key_t, typename hash_t = std::hash<key_t>>
+    class HashedFlatSet
+    {
+      public:
+        using value_t = key_t;
+        using container_t = std::vector<key_t>;
+        using iterator_t = typename container_t::iterator;
+        using const_iterator_t = typename container_t::const_iterator;
+        using reverse_iterator_t = std::reverse_iterator<iterator_t>;
+        using const_reverse_iterator_t = std::reverse_iterator<const_iterator_t>;
+
+        HashedFlatSet()
+            : m_vector()
+            , m_index()
+        {}
+
+        HashedFlatSet(const HashedFlatSet &) = default;
+        HashedFlatSet(HashedFlatSet &&) = default;
+
+        HashedFlatSet & operator=(const HashedFlatSet &) = default;
+        HashedFlatSet & operator=(HashedFlatSet &&) = default;
+
+        bool empty() const noexcept { return m_vector.empty(); }
+        std::size_t size() const noexcept { return m_vector.size(); }
+
+        void clear() noexcept
+        {
+            m_vector.clear();
+            m_index.clear();
+        }
+
+        void reserve(const std::size_t count)
+        {
+            m_vector.reserve(count);
+            m_index.reserve(count, m_vector.size(), keyAt());
+        }
+
+        std::size_t capacity() const noexcept { return m_vector.capacity(); }
+
+        void shrinkToFit()
+        {
+            m_vector.shrink_to_fit();
+            m_index.shrinkToFit(m_vector.size(), keyAt());
+        }
+
+        // does nothing if the key exists, returns (iter, was_inserted)
+        std::pair<iterator_t, bool> insert(const key_t & key) { return insertImpl(key); }
+        std::pair<iterator_t, bool> insert(key_t && key) { return insertImpl(std::move(key)); }
+
+        template <typename Iter_t>
+        void insertRange(const Iter_t first, const Iter_t last)
+        {
+            for (Iter_t iter(first); iter != last; ++iter)
+            {
+                insertImpl(*iter);
+            }
+        }
+
+        // returns how many keys were erased, which is zero or one
+        std::size_t erase(const key_t & key)
+        {
+            const std::size_t position{ positionOf(key) };
+
+            if (position == m_vector.size())
+            {
+                return 0;
+            }
+
+            m_vector.erase(std::next(std::begin(m_vector), static_cast<std::ptrdiff_t>(position)));
+            rebuildIndex();
+            return 1;
+        }
+
+        iterator_t erase(const const_iterator_t & iter) { return erase(iter, std::next(iter)); }
+
+        iterator_t erase(const const_iterator_t & from, const const_iterator_t & to)
+        {
+            const bool isErasingAny{ from != to };
+            const iterator_t iter{ m_vector.erase(from, to) };
+
+            if (isErasingAny)
+            {
+                rebuildIndex();
+            }
+
+            return iter;
+        }
+
+        iterator_t find(const key_t & key)
+        {
+            return std::next(std::begin(m_vector), static_cast<std::ptrdiff_t>(positionOf(key)));
+        }
+
+        const_iterator_t find(const key_t & key) const
+        {
+            return std::next(std::begin(m_vector), static_cast<std::ptrdiff_t>(positionOf(key)));
+        }
+
+        bool exists(const key_t & key) const { return (positionOf(key) < m_vector.size()); }
+
+        // adds every key in other that is not already in this set, after the ones already here
+        void unionWith(const HashedFlatSet & other)
+        {
+            if (&other == this)
+            {
+                return;
+            }
+
+            reserve(m_vector.size() + other.size());
+            insertRange(std::begin(other), std::end(other));
+        }
+
+        // erases every key that is not also in other
+        void intersectWith(const HashedFlatSet & other)
+        {
+            if (&other != this)
+            {
+                eraseIf([&](const key_t & key) { return !other.exists(key); });
+            }
+        }
+
+        // erases every key that is also in other
+        void difference(const HashedFlatSet & other)
+        {
+            if (&other == this)
+            {
+                clear();
+                return;
+            }
+
+            eraseIf([&](const key_t & key) { return other.exists(key); });
+        }
+
+        constexpr iterator_t begin() noexcept { return std::begin(m_vector); }
+        constexpr iterator_t end() noexcept { return std::end(m_vector); }
+
+        constexpr const_iterator_t begin() const noexcept { return std::begin(m_vector); }
+        constexpr const_iterator_t end() const noexcept { return std::end(m_vector); }
+
+        constexpr const_iterator_t cbegin() const noexcept { return begin(); }
+        constexpr const_iterator_t cend() const noexcept { return end(); }
+
+        constexpr reverse_iterator_t rbegin() noexcept { return reverse_iterator_t(end()); }
+        constexpr reverse_iterator_t rend() noexcept { return reverse_iterator_t(begin()); }
+
+        constexpr const_reverse_iterator_t rbegin() const noexcept
+        {
+            return const_reverse_iterator_t(end());
+        }
+
+        constexpr const_reverse_iterator_t rend() const noexcept
+        {
+            return const_reverse_iterator_t(begin());
+        }
+
+        constexpr const_reverse_iterator_t crbegin() const noexcept { return rbegin(); }
+        constexpr const_reverse_iterator_t crend() const noexcept { return rend(); }
+
+      private:
+        // what the index is given to see the keys
+        auto keyAt() const noexcept
+        {
+            return [this](const std::size_t position) -> const key_t & {
+                return m_vector[position];
+            };
+        }
+
+        // returns size() if not found
+        std::size_t positionOf(const key_t & key) const
+        {
+            return m_index.positionOf(key, keyAt(), m_vector.size());
+        }
+
+        void rebuildIndex() { m_index.rebuild(m_vector.size(), keyAt()); }
+
+        template <typename K>
+        std::pair<iterator_t, bool> insertImpl(K && key)
+        {
+            const std::size_t position{ positionOf(key) };
+
+            if (position < m_vector.size())
+            {
+                return { (std::begin(m_vector) + static_cast<std::ptrdiff_t>(position)), false };
+            }
+
+            // grow first so that nothing can throw after the vector has changed
+            m_index.reserveOneMore(m_vector.size(), keyAt());
+            m_vector.push_back(std::forward<K>(key));
+            m_index.indexPosition((m_vector.size() - 1), keyAt());
+            return { std::prev(std::end(m_vector)), true };
+        }
+
+        // one pass that keeps the order, then one rebuild of the index if anything was erased
+        template <typename Pred_t>
+        void eraseIf(Pred_t pred)
+        {
+            const auto newEnd{ std::remove_if(std::begin(m_vector), std::end(m_vector), pred) };
+
+            if (newEnd != std::end(m_vector))
+            {
+                m_vector.erase(newEnd, std::end(m_vector));
+                rebuildIndex();
+            }
+        }
+
+      private:
+        container_t m_vector;
+        HashedIndex<key_t, hash_t> m_index;
+    };
+
+    //
+
+    // sets are compared as sets, so the order keys were inserted in does not matter
+    template <typename key_t, typename hash_t>
+    bool operator==(
+        const HashedFlatSet<key_t, hash_t> & left, const HashedFlatSet<key_t, hash_t> & right)
+    {
+        if (left.size() != right.size())
+        {
+            return false;
+        }
+
+        return std::all_of(std::begin(left), std::end(left), [&](const key_t & key) {
+            return right.exists(key);
+        });
+    }
+
+    template <typename key_t, typename hash_t>
+    bool operator!=(
+        const HashedFlatSet<key_t, hash_t> & left, const HashedFlatSet<key_t, hash_t> & right)
+    {
+        return !(left == right);
+    }
+
+    //
+
+    template <typename key_t, typename hash_t>
+    constexpr auto begin(HashedFlatSet<key_t, hash_t> & set) noexcept
+    {
+        return set.begin();
+    }
+
+    template <typename key_t, typename hash_t>
+    constexpr auto begin(const HashedFlatSet<key_t, hash_t> & set) noexcept
+    {
+        return set.begin();
+    }
+
+    template <typename key_t, typename hash_t>
+    constexpr auto cbegin(const HashedFlatSet<key_t, hash_t> & set) noexcept
+    {
+        return begin(set);
+    }
+
+    template <typename key_t, typename hash_t>
+    constexpr auto rbegin(HashedFlatSet<key_t, hash_t> & set) noexcept
+    {
+        return set.rbegin();
+    }
+
+    template <typename key_t, typename hash_t>
+    constexpr auto rbegin(const HashedFlatSet<key_t, hash_t> & set) noexcept
+    {
+        return set.rbegin();
+    }
+
+    template <typename key_t, typename hash_t>
+    constexpr auto crbegin(const HashedFlatSet<key_t, hash_t> & set) noexcept
+    {
+        return rbegin(set);
+    }
+
+    template <typename key_t, typename hash_t>
+    constexpr auto end(HashedFlatSet<key_t, hash_t> & set) noexcept
+    {
+        return set.end();
+    }
+
+    template <typename key_t, typename hash_t>
+    constexpr auto end(const HashedFlatSet<key_t, hash_t> & set) noexcept
+    {
+        return set.end();
+    }
+
+    template <typename key_t, typename hash_t>
+    constexpr auto cend(const HashedFlatSet<key_t, hash_t> & set) noexcept
+    {
+        return end(set);
+    }
+
+    template <typename key_t, typename hash_t>
+    constexpr auto rend(HashedFlatSet<key_t, hash_t> & set) noexcept
+    {
+        return set.rend();
+    }
+
+    template <typename key_t, typename hash_t>
+    constexpr auto rend(const HashedFlatSet<key_t, hash_t> & set) noexcept
+    {
+        return set.rend();
+    }
+
+    template <typename key_t, typename hash_t>
+    constexpr auto crend(const HashedFlatSet<key_t, hash_t> & set) noexcept
+    {
+        return rend(set);
+    }
+
+#if __has_include(<memory_resource>)
+    namespace pmr
+    {
+
+        // A FlatSet that allocates from a std::pmr::memory_resource.
+        template <typename key_t>
+        using FlatSet = utilz::FlatSet<key_t, std::pmr::vector<key_t>>;
+
+    } // namespace pmr
+#endif
+
+} // namespace utilz
+
+#endif // FLAT_SET_HPP_INCLUDED
@@ -0,0 +1,166 @@
+#ifndef FROZEN_FLAT_MAP_HPP_INCLUDED
+#define FROZEN_FLAT_MAP_HPP_INCLUDED
+//
+// frozen-flat-map.hpp
+//
+#include "utilz/flat-map.hpp"
+#include "utilz/simd.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace utilz
+{
+
+    // A read-only copy of a FlatMap for big maps that are looked up far more than they change.
+    // Make one with freeze(map).
+    //
+    // Binary searching a sorted vector misses cache on nearly every step once the map is bigger
+    // than the cache, because each step jumps to a far away place.  Here the keys are laid out in
+    // Eytzinger (breadth first) order instead: the root first, then its two children, then their
+    // four, and so on.  The children of slot k are always at 2k and 2k+1, so the search is a
+    // simple branchless loop, and all the keys a few steps ahead sit together so they can be
+    // prefetched.  Values are kept in the same order in a parallel vector, see indexOf().
+    //
+    // Duplicate keys are removed keeping the first, just like FlatMap::sortAndUnique().
+    template <typename key_t, typename data_t>
+    class FrozenFlatMap
+    {
+      public:
+        using value_t = std::pair<key_t, data_t>;
+        using key_container_t = std::vector<key_t>;
+        using data_container_t = std::vector<data_t>;
+
+        FrozenFlatMap()
+            : m_keys()
+            , m_values()
+        {}
+
+        template <typename storage_t>
+        explicit FrozenFlatMap(FlatMap<key_t, data_t, storage_t> map)
+            : m_keys()
+            , m_values()
+        {
+            map.sortAndUnique();
+
+            const std::size_t count{ map.size() };
+            std::vector<std::size_t> sortedIndexes(count);
+            std::size_t nextSortedIndex{ 0 };
+            layOut(sortedIndexes, nextSortedIndex, 1);
+
+            m_keys.reserve(count);
+            m_values.reserve(count);
+            const auto sortedBegin{ std::begin(map) };
+            for (const std::size_t sortedIndex : sortedIndexes)
+            {
+                auto & pair{ sortedBegin[static_cast<std::ptrdiff_t>(sortedIndex)] };
+                m_keys.push_back(std::move(pair.first));
+                m_values.push_back(std::move(pair.second));
+            }
+        }
+
+        FrozenFlatMap(const FrozenFlatMap &) = default;
+        FrozenFlatMap(FrozenFlatMap &&) = default;
+
+        FrozenFlatMap & operator=(const FrozenFlatMap &) = default;
+        FrozenFlatMap & operator=(FrozenFlatMap &&) = default;
+
+        bool empty() const noexcept { return m_keys.empty(); }
+        std::size_t size() const noexcept { return m_keys.size(); }
+
+        // both in Eytzinger order, not sorted order
+        const key_container_t & keys() const noexcept { return m_keys; }
+        const data_container_t & values() const noexcept { return m_values; }
+
+        const data_t & at(const key_t & key) const
+        {
+            const std::size_t index{ indexOf(key) };
+
+            if (index == m_keys.size())
+            {
+                throw std::out_of_range("FrozenFlatMap::at()const - key not found");
+            }
+
+            return m_values[index];
+        }
+
+        bool exists(const key_t & key) const { return (indexOf(key) < m_keys.size()); }
+
+        // returns size() if not found, otherwise the index into keys() and values()
+        std::size_t indexOf(const key_t & key) const
+        {
+            const std::size_t count{ m_keys.size() };
+
+            // one-based so that the children of k are 2k and 2k+1
+            std::size_t slot{ 1 };
+            while (slot <= count)
+            {
+                simd::prefetch(m_keys.data() + std::min((slot * prefetchStride), count));
+                slot = ((2 * slot) + static_cast<std::size_t>(m_keys[slot - 1] < key));
+            }
+
+            // Every step right added a one bit, so dropping the trailing ones and then the last
+            // left step gives the slot of the lower bound, or zero if every key was smaller.
+            while ((slot & 1) != 0)
+            {
+                slot >>= 1;
+            }
+
+            slot >>= 1;
+
+            if ((0 == slot) || (key < m_keys[slot - 1]))
+            {
+                return count;
+            }
+
+            return (slot - 1);
+        }
+
+      private:
+        // The keys four levels below slot k start at 16k, which is a whole cache line of small
+        // keys.  Fetching those while the next four comparisons run hides most of the misses.
+        static constexpr std::size_t prefetchStride{ std::max(
+            std::size_t(1), std::min(std::size_t(16), (64 / sizeof(key_t)))) };
+
+        // an in-order walk of the tree hands out the sorted indexes from smallest to largest
+        static void layOut(
+            std::vector<std::size_t> & sortedIndexes,
+            std::size_t & nextSortedIndex,
+            const std::size_t slot)
+        {
+            if (slot > sortedIndexes.size())
+            {
+                return;
+            }
+
+            layOut(sortedIndexes, nextSortedIndex, (2 * slot));
+            sortedIndexes[slot - 1] = nextSortedIndex++;
+            layOut(sortedIndexes, nextSortedIndex, ((2 * slot) + 1));
+        }
+
+      private:
+        key_container_t m_keys;
+        data_container_t m_values;
+    };
+
+    //
+
+    // skips anything FlatMap::markErased()
+    template <typename key_t, typename data_t, typename storage_t>
+    FrozenFlatMap<key_t, data_t> freeze(const FlatMap<key_t, data_t, storage_t> & map)
+    {
+        return FrozenFlatMap<key_t, data_t>(map);
+    }
+
+    template <typename key_t, typename data_t, typename storage_t>
+    FrozenFlatMap<key_t, data_t> freeze(FlatMap<key_t, data_t, storage_t> && map)
+    {
+        return FrozenFlatMap<key_t, data_t>(std::move(map));
+    }
+
+} // namespace utilz
+
+#endif // FROZEN_FLAT_MAP_HPP_INCLUDED
@@ -0,0 +1,22 @@
+#ifndef HASH_MIX_HPP_INCLUDED
+#define HASH_MIX_HPP_INCLUDED
+//
+// hash-mix.hpp
+//
+#include <cstdint>
+
+namespace utilz
+{
+
+    // std::hash of integers is often just the number, so spread the bits before using them.
+    // The multiply pushes every bit of the hash up into the high bits, and the xor folds those
+    // back down so that the low bits are mixed too.
+    constexpr std::uint64_t mixHash(const std::uint64_t hash) noexcept
+    {
+        const std::uint64_t mixed{ hash * 0x9E3779B97F4A7C15ull };
+        return (mixed ^ (mixed >> 32));
+    }
+
+} // namespace utilz
+
+#endif // HASH_MIX_HPP_INCLUDED
@@ -0,0 +1,714 @@
+#ifndef HASHED_FLAT_MAP_HPP_INCLUDED
+#define HASHED_FLAT_MAP_HPP_INCLUDED
+//
+// hashed-flat-map.hpp
+//
+#include "utilz/hash-mix.hpp"
+#include "utilz/simd.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace utilz
+{
+
+    // The swiss-table style hashed index of HashedFlatMap and HashedFlatSet, which only holds
+    // positions into a vector that the map or set owns.  So every function that needs to look at
+    // a key is given keyAt, a function that returns the key at a position of that vector.
+    //
+    // The index is an open addressing table of one control byte per slot (7 bits of the hash, or
+    // empty) that is probed 16 bytes at a time with SIMD, plus a parallel array of positions.
+    // Each key is only indexed once, so with duplicate keys only the first position is found.
+    template <typename key_t, typename hash_t = std::hash<key_t>>
+    class HashedIndex
+    {
+      public:
+        HashedIndex()
+            : m_controls()
+            , m_positions()
+            , m_indexedCount(0)
+            , m_hasher()
+        {}
+
+        // how many different keys are indexed
+        std::size_t indexedCount() const noexcept { return m_indexedCount; }
+
+        void clear() noexcept
+        {
+            std::fill(std::begin(m_controls), std::end(m_controls), emptyControl);
+            m_indexedCount = 0;
+        }
+
+        std::uint64_t hashOf(const key_t & key) const
+        {
+            return mixHash(static_cast<std::uint64_t>(m_hasher(key)));
+        }
+
+        // makes room for count keys, positionCount is the size of the vector as it is now
+        template <typename KeyAt_t>
+        void reserve(const std::size_t count, const std::size_t positionCount, KeyAt_t keyAt)
+        {
+            if (slotCountFor(count) > m_controls.size())
+            {
+                rehash(slotCountFor(count), positionCount, keyAt);
+            }
+        }
+
+        // call before adding to the vector so that nothing can throw after it has changed
+        template <typename KeyAt_t>
+        void reserveOneMore(const std::size_t positionCount, KeyAt_t keyAt)
+        {
+            if (((m_indexedCount + 1) * 8) > (m_controls.size() * 7))
+            {
+                rehash(std::max(groupSize, (m_controls.size() * 2)), positionCount, keyAt);
+            }
+        }
+
+        template <typename KeyAt_t>
+        void shrinkToFit(const std::size_t positionCount, KeyAt_t keyAt)
+        {
+            rehash(slotCountFor(m_indexedCount), positionCount, keyAt);
+            m_controls.shrink_to_fit();
+            m_positions.shrink_to_fit();
+        }
+
+        // for after the vector was changed in any way other than adding to the back
+        template <typename KeyAt_t>
+        void rebuild(const std::size_t positionCount, KeyAt_t keyAt)
+        {
+            rehash(std::max(m_controls.size(), slotCountFor(positionCount)), positionCount, keyAt);
+        }
+
+        // returns notFound if not found
+        template <typename KeyAt_t>
+        std::size_t
+            positionOf(const key_t & key, KeyAt_t keyAt, const std::size_t notFound) const
+        {
+            if (m_indexedCount == 0)
+            {
+                return notFound;
+            }
+
+            return positionOf(key, hashOf(key), keyAt, notFound);
+        }
+
+        // same as above for when the hash is already known, the index must not be empty
+        template <typename KeyAt_t>
+        std::size_t positionOf(
+            const key_t & key,
+            const std::uint64_t hash,
+            KeyAt_t keyAt,
+            const std::size_t notFound) const
+        {
+            const std::int8_t control{ controlOf(hash) };
+            const std::size_t groupMask{ (m_controls.size() / groupSize) - 1 };
+
+            std::size_t group{ firstGroupOf(hash) };
+
+            // triangular probing visits every group when the group count is a power of two
+            for (std::size_t probe(0); probe <= groupMask; ++probe)
+            {
+                const std::size_t firstSlot{ group * groupSize };
+                const std::int8_t * controls{ &m_controls[firstSlot] };
+
+                unsigned matches{ simd::matchBytes16(controls, control) };
+                while (matches != 0)
+                {
+                    const std::size_t slot{ firstSlot + simd::countTrailingZeros(matches) };
+                    const std::size_t position{ m_positions[slot] };
+
+                    if (keyAt(position) == key)
+                    {
+                        return position;
+                    }
+
+                    matches &= (matches - 1);
+                }
+
+                if (simd::matchBytes16(controls, emptyControl) != 0)
+                {
+                    break;
+                }
+
+                group = ((group + probe + 1) & groupMask);
+            }
+
+            return notFound;
+        }
+
+        // starts loading where a lookup of this hash will probe first, the index must not be empty
+        void prefetch(const std::uint64_t hash) const noexcept
+        {
+            const std::size_t firstSlot{ firstGroupOf(hash) * groupSize };
+            simd::prefetch(&m_controls[firstSlot]);
+            simd::prefetch(&m_positions[firstSlot]);
+        }
+
+        // adds the key at this position to the index unless that key is already in there
+        // the caller must make sure there is room first
+        template <typename KeyAt_t>
+        void indexPosition(const std::size_t position, KeyAt_t keyAt)
+        {
+            const key_t & key{ keyAt(position) };
+            const std::uint64_t hash{ hashOf(key) };
+            const std::int8_t control{ controlOf(hash) };
+            const std::size_t groupMask{ (m_controls.size() / groupSize) - 1 };
+
+            std::size_t group{ firstGroupOf(hash) };
+
+            for (std::size_t probe(0); probe <= groupMask; ++probe)
+            {
+                const std::size_t firstSlot{ group * groupSize };
+                const std::int8_t * controls{ &m_controls[firstSlot] };
+
+                unsigned matches{ simd::matchBytes16(controls, control) };
+                while (matches != 0)
+                {
+                    const std::size_t slot{ firstSlot + simd::countTrailingZeros(matches) };
+
+                    if (keyAt(m_positions[slot]) == key)
+                    {
+                        return;
+                    }
+
+                    matches &= (matches - 1);
+                }
+
+                const unsigned empties{ simd::matchBytes16(controls, emptyControl) };
+                if (empties != 0)
+                {
+                    const std::size_t slot{ firstSlot + simd::countTrailingZeros(empties) };
+                    m_controls[slot] = control;
+                    m_positions[slot] = position;
+                    ++m_indexedCount;
+                    return;
+                }
+
+                group = ((group + probe + 1) & groupMask);
+            }
+        }
+
+      private:
+        static constexpr std::size_t groupSize{ 16 };
+        static constexpr std::int8_t emptyControl{ -128 };
+
+        // the low 7 bits go in the control byte, the rest pick where to start probing
+        static std::int8_t controlOf(const std::uint64_t hash) noexcept
+        {
+            return static_cast<std::int8_t>(hash & 0x7F);
+        }
+
+        std::size_t firstGroupOf(const std::uint64_t hash) const noexcept
+        {
+            return static_cast<std::size_t>((hash >> 7) & ((m_controls.size() / groupSize) - 1));
+        }
+
+        // always a power of two number of groups with at most 7/8 of the slots used
+        static std::size_t slotCountFor(const std::size_t count) noexcept
+        {
+            std::size_t slotCount{ groupSize };
+
+            while ((count * 8) > (slotCount * 7))
+            {
+                slotCount *= 2;
+            }
+
+            return slotCount;
+        }
+
+        template <typename KeyAt_t>
+        void rehash(const std::size_t slotCount, const std::size_t positionCount, KeyAt_t keyAt)
+        {
+            m_controls.assign(slotCount, emptyControl);
+            m_positions.assign(slotCount, 0);
+            m_indexedCount = 0;
+
+            for (std::size_t position(0); position < positionCount; ++position)
+            {
+                indexPosition(position, keyAt);
+            }
+        }
+
+      private:
+        std::vector<std::int8_t> m_controls;
+        std::vector<std::size_t> m_positions;
+        std::size_t m_indexedCount;
+
+        hash_t m_hasher;
+    };
+
+    //
+
+    // A FlatMap with a swiss-table style hashed index on the side, so lookups are O(1) expected
+    // while iterating is still a plain walk over a vector in insertion order.  See HashedIndex.
+    // The vector itself is exactly what a FlatMap would hold.
+    //
+    // append() still allows duplicate keys, but lookups only ever see the first one.
+    // Erasing shifts the vector so it rebuilds the index, which is O(n) just like FlatMap.
+    // Changing keys through iterators will break the index, so don't.
+    template <typename key_t, typename data_t, typename hash_t = std::hash<key_t>>
+    class HashedFlatMap
+    {
+      public:
+        using value_t = std::pair<key_t, data_t>;
+        using container_t = std::vector<value_t>;
+        using iterator_t = typename container_t::iterator;
+        using const_iterator_t = typename container_t::const_iterator;
+        using reverse_iterator_t = std::reverse_iterator<iterator_t>;
+        using const_reverse_iterator_t = std::reverse_iterator<const_iterator_t>;
+
+        HashedFlatMap()
+            : m_vector()
+            , m_index()
+        {}
+
+        HashedFlatMap(const HashedFlatMap &) = default;
+        HashedFlatMap(HashedFlatMap &&) = default;
+
+        HashedFlatMap & operator=(const HashedFlatMap &) = default;
+        HashedFlatMap & operator=(HashedFlatMap &&) = default;
+
+        bool empty() const noexcept { return m_vector.empty(); }
+        std::size_t size() const noexcept { return m_vector.size(); }
+
+        void clear() noexcept
+        {
+            m_vector.clear();
+            m_index.clear();
+        }
+
+        void reserve(const std::size_t count)
+        {
+            m_vector.reserve(count);
+            m_index.reserve(count, m_vector.size(), keyAt());
+        }
+
+        std::size_t capacity() const noexcept { return m_vector.capacity(); }
+
+        void shrinkToFit()
+        {
+            m_vector.shrink_to_fit();
+            m_index.shrinkToFit(m_vector.size(), keyAt());
+        }
+
+        data_t & operator[](const key_t & key)
+        {
+            const std::size_t position{ positionOf(key) };
+
+            if (position < m_vector.size())
+            {
+                return m_vector[position].second;
+            }
+
+            append(key, data_t{});
+            return m_vector.back().second;
+        }
+
+        data_t & at(const key_t & key)
+        {
+            const std::size_t position{ positionOf(key) };
+
+            if (position == m_vector.size())
+            {
+                throw std::out_of_range("HashedFlatMap::at() - key not found");
+            }
+
+            return m_vector[position].second;
+        }
+
+        const data_t & at(const key_t & key) const
+        {
+            const std::size_t position{ positionOf(key) };
+
+            if (position == m_vector.size())
+            {
+                throw std::out_of_range("HashedFlatMap::at()const - key not found");
+            }
+
+            return m_vector[position].second;
+        }
+
+        // duplicate keys maintained, but only the first is ever found
+        void append(const value_t & pair) { append(pair.first, pair.second); }
+
+        void append(const key_t & key, const data_t & data)
+        {
+            m_index.reserveOneMore(m_vector.size(), keyAt());
+            m_vector.emplace_back(key, data);
+            m_index.indexPosition((m_vector.size() - 1), keyAt());
+        }
+
+        // will erase all duplicate keys
+        void erase(const key_t & key)
+        {
+            const std::size_t sizeBefore{ m_vector.size() };
+
+            m_vector.erase(
+                std::remove_if(
+                    std::begin(m_vector),
+                    std::end(m_vector),
+                    [&](const value_t & pair) { return (key == pair.first); }),
+                std::end(m_vector));
+
+            if (m_vector.size() != sizeBefore)
+            {
+                rebuildIndex();
+            }
+        }
+
+        iterator_t erase(const const_iterator_t & iter) { return erase(iter, std::next(iter)); }
+
+        iterator_t erase(const const_iterator_t & from, const const_iterator_t & to)
+        {
+            const iterator_t iter{ m_vector.erase(from, to) };
+
+            if (from != to)
+            {
+                rebuildIndex();
+            }
+
+            return iter;
+        }
+
+        iterator_t find(const key_t & key)
+        {
+            return (std::begin(m_vector) + static_cast<std::ptrdiff_t>(positionOf(key)));
+        }
+
+        const_iterator_t find(const key_t & key) const
+        {
+            return (std::begin(m_vector) + static_cast<std::ptrdiff_t>(positionOf(key)));
+        }
+
+        bool exists(const key_t & key) const { return (positionOf(key) < m_vector.size()); }
+
+        // Looks up every key in [first, last) and writes one iterator per key (end() if not found)
+        // to out, in the same order as the keys.  The keys are hashed a batch at a time and the
+        // start of each probe is prefetched before any are probed, so the cache misses of a batch
+        // overlap instead of happening one after the other.  Needs forward iterators.
+        template <typename Iter_t, typename Out_t>
+        Out_t findMany(const Iter_t first, const Iter_t last, Out_t out)
+        {
+            return findManyImpl(*this, first, last, out);
+        }
+
+        template <typename Iter_t, typename Out_t>
+        Out_t findMany(const Iter_t first, const Iter_t last, Out_t out) const
+        {
+            return findManyImpl(*this, first, last, out);
+        }
+
+        // same as findMany() but writes copies of the data, throws before writing anything if a
+        // key is not found
+        template <typename Iter_t, typename Out_t>
+        Out_t atMany(const Iter_t first, const Iter_t last, Out_t out) const
+        {
+            std::vector<const_iterator_t> found;
+            found.reserve(static_cast<std::size_t>(std::distance(first, last)));
+            findMany(first, last, std::back_inserter(found));
+
+            for (const const_iterator_t & iter : found)
+            {
+                if (iter == std::end(m_vector))
+                {
+                    throw std::out_of_range("HashedFlatMap::atMany()const - key not found");
+                }
+            }
+
+            for (const const_iterator_t & iter : found)
+            {
+                *out++ = iter->second;
+            }
+
+            return out;
+        }
+
+        // Removes all duplicate keys, keeping the first appended of each just like find() does,
+        // and loses the insertion order.  Only needs operator< for the keys.
+        void sortAndUnique()
+        {
+            std::stable_sort(
+                std::begin(m_vector),
+                std::end(m_vector),
+                [](const value_t & left, const value_t & right) {
+                    return (left.first < right.first);
+                });
+
+            m_vector.erase(
+                std::unique(
+                    std::begin(m_vector),
+                    std::end(m_vector),
+                    [](const value_t & left, const value_t & right) {
+                        return (left.first == right.first);
+                    }),
+                std::end(m_vector));
+
+            rebuildIndex();
+        }
+
+        constexpr iterator_t begin() noexcept { return std::begin(m_vector); }
+        constexpr iterator_t end() noexcept { return std::end(m_vector); }
+
+        constexpr const_iterator_t begin() const noexcept { return std::begin(m_vector); }
+        constexpr const_iterator_t end() const noexcept { return std::end(m_vector); }
+
+        constexpr const_iterator_t cbegin() const noexcept { return begin(); }
+        constexpr const_iterator_t cend() const noexcept { return end(); }
+
+        constexpr reverse_iterator_t rbegin() noexcept { return reverse_iterator_t(end()); }
+        constexpr reverse_iterator_t rend() noexcept { return reverse_iterator_t(begin()); }
+
+        constexpr const_reverse_iterator_t rbegin() const noexcept
+        {
+            return const_reverse_iterator_t(end());
+        }
+
+        constexpr const_reverse_iterator_t rend() const noexcept
+        {
+            return const_reverse_iterator_t(begin());
+        }
+
+        constexpr const_reverse_iterator_t crbegin() const noexcept { return rbegin(); }
+        constexpr const_reverse_iterator_t crend() const noexcept { return rend(); }
+
+        // clang-format off
+        template<typename T, typename U, typename H>
+        friend bool
+            operator==(const HashedFlatMap<T, U, H> & left, const HashedFlatMap<T, U, H> & right);
+
+        template<typename T, typename U, typename H>
+        friend bool
+            operator<(const HashedFlatMap<T, U, H> & left, const HashedFlatMap<T, U, H> & right);
+        // clang-format on
+
+      private:
+        // how many keys findMany() has in flight at once
+        static constexpr std::size_t findBatchSize{ 16 };
+
+        // what the index is given to see the keys
+        auto keyAt() const noexcept
+        {
+            return [this](const std::size_t position) -> const key_t & {
+                return m_vector[position].first;
+            };
+        }
+
+        // returns size() if not found
+        std::size_t positionOf(const key_t & key) const
+        {
+            return m_index.positionOf(key, keyAt(), m_vector.size());
+        }
+
+        void rebuildIndex() { m_index.rebuild(m_vector.size(), keyAt()); }
+
+        // one version for both const and non-const maps
+        template <typename map_t, typename Iter_t, typename Out_t>
+        static Out_t findManyImpl(map_t & map, Iter_t first, const Iter_t last, Out_t out)
+        {
+            const auto vectorBegin{ std::begin(map.m_vector) };
+
+            if (map.m_index.indexedCount() == 0)
+            {
+                for (; first != last; ++first)
+                {
+                    *out++ = std::end(map.m_vector);
+                }
+
+                return out;
+            }
+
+            std::array<Iter_t, findBatchSize> keys;
+            std::array<std::uint64_t, findBatchSize> hashes;
+
+            while (first != last)
+            {
+                std::size_t count{ 0 };
+                for (; (first != last) && (count < findBatchSize); ++first, ++count)
+                {
+                    keys[count] = first;
+                    hashes[count] = map.m_index.hashOf(*first);
+                    map.m_index.prefetch(hashes[count]);
+                }
+
+                for (std::size_t i(0); i < count; ++i)
+                {
+                    const std::size_t position{ map.m_index.positionOf(
+                        *keys[i], hashes[i], map.keyAt(), map.m_vector.size()) };
+                    *out++ = (vectorBegin + static_cast<std::ptrdiff_t>(position));
+                }
+            }
+
+            return out;
+        }
+
+        // returns a sorted copy, needed only when there are duplicate keys
+        static container_t sortedCopy(const HashedFlatMap & map)
+        {
+            container_t copy{ map.m_vector };
+            std::sort(std::begin(copy), std::end(copy));
+            return copy;
+        }
+
+      private:
+        container_t m_vector;
+        HashedIndex<key_t, hash_t> m_index;
+    };
+
+    //
+
+    template <typename key_t, typename data_t, typename hash_t>
+    bool operator==(
+        const HashedFlatMap<key_t, data_t, hash_t> & left,
+        const HashedFlatMap<key_t, data_t, hash_t> & right)
+    {
+        if (left.size() != right.size())
+        {
+            return false;
+        }
+
+        // without duplicates every entry can simply be looked up in the other map
+        if ((left.m_index.indexedCount() == left.size()) &&
+            (right.m_index.indexedCount() == right.size()))
+        {
+            for (const auto & pair : left)
+            {
+                const auto iter{ right.find(pair.first) };
+
+                if ((iter == std::end(right)) || !(iter->second == pair.second))
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        using map_t = HashedFlatMap<key_t, data_t, hash_t>;
+        return (map_t::sortedCopy(left) == map_t::sortedCopy(right));
+    }
+
+    template <typename key_t, typename data_t, typename hash_t>
+    bool operator!=(
+        const HashedFlatMap<key_t, data_t, hash_t> & left,
+        const HashedFlatMap<key_t, data_t, hash_t> & right)
+    {
+        return !(left == right);
+    }
+
+    template <typename key_t, typename data_t, typename hash_t>
+    bool operator<(
+        const HashedFlatMap<key_t, data_t, hash_t> & left,
+        const HashedFlatMap<key_t, data_t, hash_t> & right)
+    {
+        using map_t = HashedFlatMap<key_t, data_t, hash_t>;
+        return (map_t::sortedCopy(left) < map_t::sortedCopy(right));
+    }
+
+    template <typename key_t, typename data_t, typename hash_t>
+    bool operator>(
+        const HashedFlatMap<key_t, data_t, hash_t> & left,
+        const HashedFlatMap<key_t, data_t, hash_t> & right)
+    {
+        return (right < left);
+    }
+
+    template <typename key_t, typename data_t, typename hash_t>
+    bool operator<=(
+        const HashedFlatMap<key_t, data_t, hash_t> & left,
+        const HashedFlatMap<key_t, data_t, hash_t> & right)
+    {
+        return !(left > right);
+    }
+
+    template <typename key_t, typename data_t, typename hash_t>
+    bool operator>=(
+        const HashedFlatMap<key_t, data_t, hash_t> & left,
+        const HashedFlatMap<key_t, data_t, hash_t> & right)
+    {
+        return !(left < right);
+    }
+
+    //
+
+    template <typename key_t, typename data_t, typename hash_t>
+    constexpr auto begin(HashedFlatMap<key_t, data_t, hash_t> & map) noexcept
+    {
+        return map.begin();
+    }
+
+    template <typename key_t, typename data_t, typename hash_t>
+    constexpr auto begin(const HashedFlatMap<key_t, data_t, hash_t> & map) noexcept
+    {
+        return map.begin();
+    }
+
+    template <typename key_t, typename data_t, typename hash_t>
+    constexpr auto cbegin(const HashedFlatMap<key_t, data_t, hash_t> & map) noexcept
+    {
+        return begin(map);
+    }
+
+    template <typename key_t, typename data_t, typename hash_t>
+    constexpr auto rbegin(HashedFlatMap<key_t, data_t, hash_t> & map) noexcept
+    {
+        return map.rbegin();
+    }
+
+    template <typename key_t, typename data_t, typename hash_t>
+    constexpr auto rbegin(const HashedFlatMap<key_t, data_t, hash_t> & map) noexcept
+    {
+        return map.rbegin();
+    }
+
+    template <typename key_t, typename data_t, typename hash_t>
+    constexpr auto crbegin(const HashedFlatMap<key_t, data_t, hash_t> & map) noexcept
+    {
+        return rbegin(map);
+    }
+
+    template <typename key_t, typename data_t, typename hash_t>
+    constexpr auto end(HashedFlatMap<key_t, data_t, hash_t> & map) noexcept
+    {
+        return map.end();
+    }
+
+    template <typename key_t, typename data_t, typename hash_t>
+    constexpr auto end(const HashedFlatMap<key_t, data_t, hash_t> & map) noexcept
+    {
+        return map.end();
+    }
+
+    template <typename key_t, typename data_t, typename hash_t>
+    constexpr auto cend(const HashedFlatMap<key_t, data_t, hash_t> & map) noexcept
+    {
+        return end(map);
+    }
+
+    template <typename key_t, typename data_t, typename hash_t>
+    constexpr auto rend(HashedFlatMap<key_t, data_t, hash_t> & map) noexcept
+    {
+        return map.rend();
+    }
+
+    template <typename key_t, typename data_t, typename hash_t>
+    constexpr auto rend(const HashedFlatMap<key_t, data_t, hash_t> & map) noexcept
+    {
+        return map.rend();
+    }
+
+    template <typename key_t, typename data_t, typename hash_t>
+    constexpr auto crend(const HashedFlatMap<key_t, data_t, hash_t> & map) noexcept
+    {
+        return rend(map);
+    }
+
+} // namespace utilz
+
+#endif // HASHED_FLAT_MAP_HPP_INCLUDED
@@ -0,0 +1,448 @@
+#ifndef MAPPED_FLAT_MAP_HPP_INCLUDED
+#define MAPPED_FLAT_MAP_HPP_INCLUDED
+//
+// mapped-flat-map.hpp
+//
+#include "utilz/flat-map.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace utilz
+{
+
+    // The start of every file written by save(map, path).  After it come all the keys sorted,
+    // and then all the data in the same order, each array starting on a multiple of 64 bytes.
+    // The values are raw memory, so images only load on machines with the same byte order and
+    // type sizes, which open() checks as far as it can.
+    struct FlatMapImageHeader
+    {
+        static constexpr char magicExpected[8] = { 'U', 'T', 'I', 'L', 'Z', 'F', 'M', '\0' };
+        static constexpr std::uint32_t versionExpected{ 1 };
+        static constexpr std::uint32_t byteOrderExpected{ 0x01020304 };
+        static constexpr std::uint64_t alignment{ 64 };
+
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t byteOrder;
+        std::uint32_t keySize;
+        std::uint32_t dataSize;
+        std::uint64_t count;
+        std::uint64_t keysOffset;
+        std::uint64_t valuesOffset;
+
+        static constexpr std::uint64_t alignUp(const std::uint64_t offset) noexcept
+        {
+            return (((offset + alignment) - 1) / alignment) * alignment;
+        }
+    };
+
+    static_assert(sizeof(FlatMapImageHeader) == 48, "FlatMapImageHeader must not have padding.");
+
+    // Writes the map in the binary format that MappedFlatMap::open() loads without parsing or
+    // copying anything.  The image is sorted by key with duplicates removed keeping the first,
+    // just like FlatMap::sortAndUnique(), and anything FlatMap::markErased() is left out.
+    // Only for keys and data that are trivially copyable.  Throws std::runtime_error.
+    template <typename key_t, typename data_t, typename storage_t>
+    void save(const FlatMap<key_t, data_t, storage_t> & map, const std::string & path)
+    {
+        static_assert(
+            std::is_trivially_copyable_v<key_t> && std::is_trivially_copyable_v<data_t>,
+            "Only maps of trivially copyable keys and data can be saved as images.");
+
+        using value_t = std::pair<key_t, data_t>;
+
+        std::vector<const value_t *> entries;
+        entries.reserve(map.size());
+        for (auto iter(std::begin(map)); iter != std::end(map); ++iter)
+        {
+            if (!map.isMarkedErased(iter))
+            {
+                entries.push_back(&*iter);
+            }
+        }
+
+        std::stable_sort(
+            std::begin(entries), std::end(entries), [](const value_t * a, const value_t * b) {
+                return (a->first < b->first);
+            });
+
+        entries.erase(
+            std::unique(
+                std::begin(entries),
+                std::end(entries),
+                [](const value_t * a, const value_t * b) { return (a->first == b->first); }),
+            std::end(entries));
+
+        FlatMapImageHeader header;
+        std::memcpy(header.magic, FlatMapImageHeader::magicExpected, sizeof(header.magic));
+        header.version = FlatMapImageHeader::versionExpected;
+        header.byteOrder = FlatMapImageHeader::byteOrderExpected;
+        header.keySize = static_cast<std::uint32_t>(sizeof(key_t));
+        header.dataSize = static_cast<std::uint32_t>(sizeof(data_t));
+        header.count = entries.size();
+        header.keysOffset = FlatMapImageHeader::alignUp(sizeof(FlatMapImageHeader));
+
+        header.valuesOffset =
+            FlatMapImageHeader::alignUp(header.keysOffset + (header.count * sizeof(key_t)));
+
+        std::ofstream file(path, (std::ios::binary | std::ios::trunc));
+        if (!file)
+        {
+            throw std::runtime_error("utilz::save() unable to open for writing: " + path);
+        }
+
+        const char zeros[FlatMapImageHeader::alignment] = {};
+        std::uint64_t offset{ 0 };
+
+        const auto write{ [&](const void * bytes, const std::uint64_t count) {
+            file.write(static_cast<const char *>(bytes), static_cast<std::streamsize>(count));
+            offset += count;
+        } };
+
+        write(&header, sizeof(header));
+        write(zeros, (header.keysOffset - offset));
+
+        for (const value_t * pair : entries)
+        {
+            write(&pair->first, sizeof(key_t));
+        }
+
+        write(zeros, (header.valuesOffset - offset));
+
+        for (const value_t * pair : entries)
+        {
+            write(&pair->second, sizeof(data_t));
+        }
+
+        file.flush();
+        if (!file)
+        {
+            throw std::runtime_error("utilz::save() failed writing to: " + path);
+        }
+    }
+
+    //
+
+    // A whole file mapped read-only into memory, unmapped when destroyed.
+    class MappedFile
+    {
+      public:
+        MappedFile() noexcept
+            : m_data(nullptr)
+            , m_size(0)
+        {}
+
+        // throws std::runtime_error if the file can't be opened or mapped
+        explicit MappedFile(const std::string & path)
+            : MappedFile()
+        {
+#if defined(_WIN32)
+            const HANDLE file{ CreateFileA(
+                path.c_str(),
+                GENERIC_READ,
+                FILE_SHARE_READ,
+                nullptr,
+                OPEN_EXISTING,
+                FILE_ATTRIBUTE_NORMAL,
+                nullptr) };
+
+            if (file == INVALID_HANDLE_VALUE)
+            {
+                throw std::runtime_error("MappedFile() unable to open: " + path);
+            }
+
+            LARGE_INTEGER size;
+            if (!GetFileSizeEx(file, &size))
+            {
+                CloseHandle(file);
+                throw std::runtime_error("MappedFile() unable to get the size of: " + path);
+            }
+
+            if (0 == size.QuadPart)
+            {
+                CloseHandle(file);
+                return;
+            }
+
+            // the view keeps the file and mapping open by itself, so the handles can go
+            const HANDLE mapping{ CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) };
+            CloseHandle(file);
+
+            if (nullptr == mapping)
+            {
+                throw std::runtime_error("MappedFile() unable to map: " + path);
+            }
+
+            const void * view{ MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) };
+            CloseHandle(mapping);
+
+            if (nullptr == view)
+            {
+                throw std::runtime_error("MappedFile() unable to map: " + path);
+            }
+
+            m_data = static_cast<const unsigned char *>(view);
+            m_size = static_cast<std::size_t>(size.QuadPart);
+#else
+            const int file{ ::open(path.c_str(), O_RDONLY) };
+            if (file < 0)
+            {
+                throw std::runtime_error("MappedFile() unable to open: " + path);
+            }
+
+            struct stat info;
+            if (::fstat(file, &info) != 0)
+            {
+                ::close(file);
+                throw std::runtime_error("MappedFile() unable to get the size of: " + path);
+            }
+
+            if (0 == info.st_size)
+            {
+                ::close(file);
+                return;
+            }
+
+            // the mapping keeps the file open by itself, so the descriptor can go
+            const std::size_t size{ static_cast<std::size_t>(info.st_size) };
+            void * const address{ ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0) };
+            ::close(file);
+
+            if (MAP_FAILED == address)
+            {
+                throw std::runtime_error("MappedFile() unable to map: " + path);
+            }
+
+            m_data = static_cast<const unsigned char *>(address);
+            m_size = size;
+#endif
+        }
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile & operator=(const MappedFile &) = delete;
+
+        MappedFile(MappedFile && other) noexcept
+            : m_data(std::exchange(other.m_data, nullptr))
+            , m_size(std::exchange(other.m_size, 0))
+        {}
+
+        MappedFile & operator=(MappedFile && other) noexcept
+        {
+            if (this != &other)
+            {
+                unmap();
+                m_data = std::exchange(other.m_data, nullptr);
+                m_size = std::exchange(other.m_size, 0);
+            }
+
+            return *this;
+        }
+
+        ~MappedFile() { unmap(); }
+
+        // nullptr if the file was empty
+        const unsigned char * data() const noexcept { return m_data; }
+        std::size_t size() const noexcept { return m_size; }
+
+      private:
+        void unmap() noexcept
+        {
+            if (nullptr == m_data)
+            {
+                return;
+            }
+
+#if defined(_WIN32)
+            UnmapViewOfFile(m_data);
+#else
+            ::munmap(const_cast<unsigned char *>(m_data), m_size);
+#endif
+
+            m_data = nullptr;
+            m_size = 0;
+        }
+
+      private:
+        const unsigned char * m_data;
+        std::size_t m_size;
+    };
+
+    //
+
+    // A read-only map that serves lookups straight out of a file written by save(map, path).
+    // Nothing is parsed or copied when opening, so opening even a huge file is instant and the
+    // OS only reads in the pages that lookups actually touch.  Lookups are binary searches.
+    template <typename key_t, typename data_t>
+    class MappedFlatMap
+    {
+        static_assert(
+            std::is_trivially_copyable_v<key_t> && std::is_trivially_copyable_v<data_t>,
+            "MappedFlatMap only works with trivially copyable keys and data.");
+
+        static_assert(
+            (alignof(key_t) <= FlatMapImageHeader::alignment) &&
+                (alignof(data_t) <= FlatMapImageHeader::alignment),
+            "MappedFlatMap keys and data can't need more alignment than the image has.");
+
+      public:
+        MappedFlatMap() noexcept
+            : m_file()
+            , m_keys(nullptr)
+            , m_values(nullptr)
+            , m_size(0)
+        {}
+
+        // throws std::runtime_error if the file can't be mapped or is not an image of this type
+        static MappedFlatMap open(const std::string & path)
+        {
+            MappedFlatMap map;
+            map.m_file = MappedFile(path);
+
+            const unsigned char * const bytes{ map.m_file.data() };
+            const std::uint64_t fileSize{ map.m_file.size() };
+
+            FlatMapImageHeader header;
+            if (fileSize < sizeof(header))
+            {
+                throw std::runtime_error("MappedFlatMap::open() file is too small: " + path);
+            }
+
+            std::memcpy(&header, bytes, sizeof(header));
+
+            const bool isImageOfThisType{
+                (std::memcmp(
+                     header.magic, FlatMapImageHeader::magicExpected, sizeof(header.magic)) ==
+                 0) &&
+                (header.version == FlatMapImageHeader::versionExpected) &&
+                (header.byteOrder == FlatMapImageHeader::byteOrderExpected) &&
+                (header.keySize == sizeof(key_t)) && (header.dataSize == sizeof(data_t))
+            };
+
+            if (!isImageOfThisType)
+            {
+                throw std::runtime_error(
+                    "MappedFlatMap::open() not an image of this map type: " + path);
+            }
+
+            // every offset is checked against the file size before any arithmetic uses it, and
+            // the counts are compared by dividing, so a corrupt header can't overflow anything
+            const bool isSizeValid{
+                (header.keysOffset >= sizeof(header)) && (header.keysOffset <= fileSize) &&
+                ((header.keysOffset % FlatMapImageHeader::alignment) == 0) &&
+                (header.valuesOffset <= fileSize) &&
+                ((header.valuesOffset % FlatMapImageHeader::alignment) == 0) &&
+                (header.count <= ((fileSize - header.keysOffset) / sizeof(key_t))) &&
+                (header.count <= ((fileSize - header.valuesOffset) / sizeof(data_t))) &&
+                (header.valuesOffset >= (header.keysOffset + (header.count * sizeof(key_t))))
+            };
+
+            if (!isSizeValid)
+            {
+                throw std::runtime_error("MappedFlatMap::open() file is truncated: " + path);
+            }
+
+            map.m_keys = reinterpret_cast<const key_t *>(bytes + header.keysOffset);
+            map.m_values = reinterpret_cast<const data_t *>(bytes + header.valuesOffset);
+            map.m_size = static_cast<std::size_t>(header.count);
+            return map;
+        }
+
+        // the mapping can only have one owner, or it would be unmapped twice
+        MappedFlatMap(const MappedFlatMap &) = delete;
+        MappedFlatMap & operator=(const MappedFlatMap &) = delete;
+
+        // the moved from map is left empty instead of pointing into a mapping it no longer owns
+        MappedFlatMap(MappedFlatMap && other) noexcept
+            : m_file(std::move(other.m_file))
+            , m_keys(std::exchange(other.m_keys, nullptr))
+            , m_values(std::exchange(other.m_values, nullptr))
+            , m_size(std::exchange(other.m_size, 0))
+        {}
+
+        // moving the file in unmaps whatever this map had open before
+        MappedFlatMap & operator=(MappedFlatMap && other) noexcept
+        {
+            if (this != &other)
+            {
+                m_file = std::move(other.m_file);
+                m_keys = std::exchange(other.m_keys, nullptr);
+                m_values = std::exchange(other.m_values, nullptr);
+                m_size = std::exchange(other.m_size, 0);
+            }
+
+            return *this;
+        }
+
+        bool empty() const noexcept { return (0 == m_size); }
+        std::size_t size() const noexcept { return m_size; }
+
+        // size() of each, sorted by key, and pointing into the mapped file
+        const key_t * keys() const noexcept { return m_keys; }
+        const data_t * values() const noexcept { return m_values; }
+
+        const data_t & at(const key_t & key) const
+        {
+            const std::size_t index{ indexOf(key) };
+
+            if (index == m_size)
+            {
+                throw std::out_of_range("MappedFlatMap::at()const - key not found");
+            }
+
+            return m_values[index];
+        }
+
+        bool exists(const key_t & key) const { return (indexOf(key) < m_size); }
+
+        // returns size() if not found, otherwise the index into keys() and values()
+        std::size_t indexOf(const key_t & key) const
+        {
+            if (0 == m_size)
+            {
+                return 0;
+            }
+
+            const key_t * const iter{ std::lower_bound(m_keys, (m_keys + m_size), key) };
+
+            if ((iter == (m_keys + m_size)) || (key < *iter))
+            {
+                return m_size;
+            }
+
+            return static_cast<std::size_t>(iter - m_keys);
+        }
+
+      private:
+        MappedFile m_file;
+        const key_t * m_keys;
+        const data_t * m_values;
+        std::size_t m_size;
+    };
+
+} // namespace utilz
+
+#endif // MAPPED_FLAT_MAP_HPP_INCLUDED
@@ -0,0 +1,226 @@
+#ifndef SHARDED_FLAT_MAP_HPP_INCLUDED
+#define SHARDED_FLAT_MAP_HPP_INCLUDED
+//
+// sharded-flat-map.hpp
+//
+#include "utilz/flat-map.hpp"
+#include "utilz/hash-mix.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace utilz
+{
+
+    // A FlatMap that many threads can write to at once.  Keys are hashed into shard_count
+    // separate FlatMaps that each have their own mutex, so threads only wait on each other when
+    // they happen to use the same shard, instead of all of them waiting on one big lock.
+    //
+    // Nothing ever hands out a reference or iterator into a shard, since that would outlive the
+    // lock.  find() returns a copy, and update() runs a function on the data while it is locked.
+    template <
+        typename key_t,
+        typename data_t,
+        std::size_t shard_count = 16,
+        typename hash_t = std::hash<key_t>>
+    class ShardedFlatMap
+    {
+        static_assert(shard_count > 0, "ShardedFlatMap needs at least one shard.");
+
+      public:
+        using value_t = std::pair<key_t, data_t>;
+        using map_t = FlatMap<key_t, data_t>;
+
+        ShardedFlatMap()
+            : m_shards()
+            , m_hasher()
+        {}
+
+        // the mutexes can't be copied or moved
+        ShardedFlatMap(const ShardedFlatMap &) = delete;
+        ShardedFlatMap(ShardedFlatMap &&) = delete;
+
+        ShardedFlatMap & operator=(const ShardedFlatMap &) = delete;
+        ShardedFlatMap & operator=(ShardedFlatMap &&) = delete;
+
+        static constexpr std::size_t shardCount() noexcept { return shard_count; }
+
+        // these lock each shard in turn, so they are only exact when nothing else is writing
+        std::size_t size() const
+        {
+            std::size_t count{ 0 };
+
+            for (const Shard & shard : m_shards)
+            {
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                count += shard.map.size();
+            }
+
+            return count;
+        }
+
+        bool empty() const { return (0 == size()); }
+
+        void clear()
+        {
+            for (Shard & shard : m_shards)
+            {
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                shard.map.clear();
+            }
+        }
+
+        // returns a copy of the data because a reference would not be safe
+        std::optional<data_t> find(const key_t & key) const
+        {
+            const Shard & shard{ shardOf(key) };
+            std::lock_guard<std::mutex> lock(shard.mutex);
+
+            const auto iter{ shard.map.find(key) };
+            if (iter == std::end(shard.map))
+            {
+                return std::nullopt;
+            }
+
+            return iter->second;
+        }
+
+        bool exists(const key_t & key) const
+        {
+            const Shard & shard{ shardOf(key) };
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            return shard.map.exists(key);
+        }
+
+        // does nothing if the key already exists, returns true if inserted
+        bool insert(const key_t & key, const data_t & data)
+        {
+            Shard & shard{ shardOf(key) };
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            return shard.map.tryEmplace(key, data).second;
+        }
+
+        void insertOrAssign(const key_t & key, const data_t & data)
+        {
+            Shard & shard{ shardOf(key) };
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.map.insertOrAssign(key, data);
+        }
+
+        // Calls func(data_t &) while the shard is locked, default constructing the data first if
+        // the key is new.  This is how to change a value without a race between reading and
+        // writing it, for example ++counter.  Returns a copy of whatever func does, even if that
+        // was a reference, since a reference would outlive the lock.
+        template <typename Func_t>
+        std::decay_t<std::invoke_result_t<Func_t, data_t &>>
+            update(const key_t & key, Func_t && func)
+        {
+            Shard & shard{ shardOf(key) };
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            return std::invoke(std::forward<Func_t>(func), shard.map[key]);
+        }
+
+        // the order inside a shard does not matter, so this can use FlatMap::eraseUnordered()
+        void erase(const key_t & key)
+        {
+            Shard & shard{ shardOf(key) };
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.map.eraseUnordered(key);
+        }
+
+        // Calls func(const key_t &, data_t &) on every entry, one locked shard at a time, so other
+        // threads can keep using the rest of the map.  That also means this is not a snapshot,
+        // see snapshot().  func must not call back into this map.
+        template <typename Func_t>
+        void forEach(Func_t func)
+        {
+            for (Shard & shard : m_shards)
+            {
+                std::lock_guard<std::mutex> lock(shard.mutex);
+
+                for (value_t & pair : shard.map)
+                {
+                    func(static_cast<const key_t &>(pair.first), pair.second);
+                }
+            }
+        }
+
+        template <typename Func_t>
+        void forEach(Func_t func) const
+        {
+            for (const Shard & shard : m_shards)
+            {
+                std::lock_guard<std::mutex> lock(shard.mutex);
+
+                for (const value_t & pair : shard.map)
+                {
+                    func(pair.first, pair.second);
+                }
+            }
+        }
+
+        // A copy of everything as it was at one moment.  All shards are locked (always in the
+        // same order so this can't deadlock with itself) before any are copied.
+        map_t snapshot() const
+        {
+            std::array<std::unique_lock<std::mutex>, shard_count> locks;
+            std::size_t count{ 0 };
+
+            for (std::size_t i(0); i < shard_count; ++i)
+            {
+                locks[i] = std::unique_lock<std::mutex>(m_shards[i].mutex);
+                count += m_shards[i].map.size();
+            }
+
+            map_t map;
+            map.reserve(count);
+
+            for (const Shard & shard : m_shards)
+            {
+                for (const value_t & pair : shard.map)
+                {
+                    map.append(pair);
+                }
+            }
+
+            return map;
+        }
+
+      private:
+        // Most cpus move 64 bytes between cores at a time, so each shard starts on its own line.
+        // Otherwise threads locking neighboring shards would still fight over the same line.
+        struct alignas(64) Shard
+        {
+            Shard()
+                : mutex()
+                , map()
+            {}
+
+            mutable std::mutex mutex;
+            map_t map;
+        };
+
+        // the high bits are the best mixed, since every bit of the hash was multiplied into them
+        std::size_t shardIndexOf(const key_t & key) const
+        {
+            const std::uint64_t hash{ mixHash(static_cast<std::uint64_t>(m_hasher(key))) };
+            return static_cast<std::size_t>((hash >> 32) % shard_count);
+        }
+
+        Shard & shardOf(const key_t & key) { return m_shards[shardIndexOf(key)]; }
+        const Shard & shardOf(const key_t & key) const { return m_shards[shardIndexOf(key)]; }
+
+      private:
+        std::array<Shard, shard_count> m_shards;
+        hash_t m_hasher;
+    };
+
+} // namespace utilz
+
+#endif // SHARDED_FLAT_MAP_HPP_INCLUDED
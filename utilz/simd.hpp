@@ -0,0 +1,307 @@
+#ifndef UTILZ_SIMD_HPP_INCLUDED
+#define UTILZ_SIMD_HPP_INCLUDED
+//
+// simd.hpp
+//
+// SSE2 is part of x86-64 so it is used whenever the compiler says it is there.  AVX2 is not, so
+// it is compiled separately and only used if the cpu running the code reports it at runtime.
+// Anything else (ARM, etc.) gets the plain scalar loops.
+//
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define UTILZ_SIMD_SSE2 1
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define UTILZ_SIMD_AVX2 1
+#define UTILZ_SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(_MSC_VER)
+#define UTILZ_SIMD_AVX2 1
+#define UTILZ_SIMD_TARGET_AVX2
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+#endif
+
+namespace utilz
+{
+
+    namespace simd
+    {
+
+        // true for keys where operator== is the same as comparing the bytes
+        template <typename T>
+        constexpr bool isScannable =
+            ((std::is_integral_v<T> || std::is_enum_v<T>) &&
+             ((sizeof(T) == 1) || (sizeof(T) == 2) || (sizeof(T) == 4) || (sizeof(T) == 8)));
+
+        inline bool isAvx2Supported() noexcept
+        {
+#if defined(UTILZ_SIMD_AVX2) && defined(_MSC_VER) && !defined(__clang__)
+            static const bool isSupported{ []() {
+                int info[4] = { 0, 0, 0, 0 };
+                __cpuid(info, 1);
+
+                const bool isOsSavingAvx{ ((info[2] & (1 << 27)) != 0) &&
+                                          ((info[2] & (1 << 28)) != 0) &&
+                                          ((_xgetbv(0) & 6) == 6) };
+
+                __cpuidex(info, 7, 0);
+                return (isOsSavingAvx && ((info[1] & (1 << 5)) != 0));
+            }() };
+
+            return isSupported;
+#elif defined(UTILZ_SIMD_AVX2)
+            static const bool isSupported{ (__builtin_cpu_supports("avx2") != 0) };
+            return isSupported;
+#else
+            return false;
+#endif
+        }
+
+        // a hint to start loading the cache line holding address, does nothing where unsupported
+        inline void prefetch(const void * address) noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(address);
+#elif defined(UTILZ_SIMD_SSE2)
+            _mm_prefetch(static_cast<const char *>(address), _MM_HINT_T0);
+#else
+            static_cast<void>(address);
+#endif
+        }
+
+        inline unsigned countTrailingZeros(const unsigned bits) noexcept
+        {
+#if defined(_MSC_VER) && !defined(__clang__)
+            unsigned long index{ 0 };
+            _BitScanForward(&index, bits);
+            return static_cast<unsigned>(index);
+#else
+            return static_cast<unsigned>(__builtin_ctz(bits));
+#endif
+        }
+
+#if defined(UTILZ_SIMD_SSE2)
+
+        // value repeated in every lane
+        template <std::size_t size_bytes>
+        inline __m128i splat128(const void * value) noexcept
+        {
+            if constexpr (size_bytes == 1)
+            {
+                char number{ 0 };
+                std::memcpy(&number, value, size_bytes);
+                return _mm_set1_epi8(number);
+            }
+            else if constexpr (size_bytes == 2)
+            {
+                short number{ 0 };
+                std::memcpy(&number, value, size_bytes);
+                return _mm_set1_epi16(number);
+            }
+            else if constexpr (size_bytes == 4)
+            {
+                int number{ 0 };
+                std::memcpy(&number, value, size_bytes);
+                return _mm_set1_epi32(number);
+            }
+            else
+            {
+                long long number{ 0 };
+                std::memcpy(&number, value, size_bytes);
+                return _mm_set1_epi64x(number);
+            }
+        }
+
+        template <std::size_t size_bytes>
+        inline unsigned equalMask128(const __m128i block, const __m128i needle) noexcept
+        {
+            __m128i equal;
+
+            if constexpr (size_bytes == 1)
+            {
+                equal = _mm_cmpeq_epi8(block, needle);
+            }
+            else if constexpr (size_bytes == 2)
+            {
+                equal = _mm_cmpeq_epi16(block, needle);
+            }
+            else if constexpr (size_bytes == 4)
+            {
+                equal = _mm_cmpeq_epi32(block, needle);
+            }
+            else
+            {
+                // SSE2 has no 64 bit compare, so both 32 bit halves have to match
+                const __m128i halves{ _mm_cmpeq_epi32(block, needle) };
+                equal = _mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)));
+            }
+
+            return static_cast<unsigned>(_mm_movemask_epi8(equal));
+        }
+
+        template <std::size_t size_bytes>
+        std::size_t findEqualSse2(
+            const unsigned char * bytes, const std::size_t count, const void * value) noexcept
+        {
+            constexpr std::size_t lanes{ 16 / size_bytes };
+
+            const __m128i needle{ splat128<size_bytes>(value) };
+
+            std::size_t index{ 0 };
+            for (; (index + lanes) <= count; index += lanes)
+            {
+                const __m128i block{ _mm_loadu_si128(
+                    reinterpret_cast<const __m128i *>(bytes + (index * size_bytes))) };
+
+                const unsigned mask{ equalMask128<size_bytes>(block, needle) };
+                if (mask != 0)
+                {
+                    return (index + (countTrailingZeros(mask) / size_bytes));
+                }
+            }
+
+            return index;
+        }
+
+#endif
+
+#if defined(UTILZ_SIMD_AVX2)
+
+        template <std::size_t size_bytes>
+        UTILZ_SIMD_TARGET_AVX2 std::size_t findEqualAvx2(
+            const unsigned char * bytes, const std::size_t count, const void * value) noexcept
+        {
+            constexpr std::size_t lanes{ 32 / size_bytes };
+
+            __m256i needle;
+            if constexpr (size_bytes == 1)
+            {
+                char number{ 0 };
+                std::memcpy(&number, value, size_bytes);
+                needle = _mm256_set1_epi8(number);
+            }
+            else if constexpr (size_bytes == 2)
+            {
+                short number{ 0 };
+                std::memcpy(&number, value, size_bytes);
+                needle = _mm256_set1_epi16(number);
+            }
+            else if constexpr (size_bytes == 4)
+            {
+                int number{ 0 };
+                std::memcpy(&number, value, size_bytes);
+                needle = _mm256_set1_epi32(number);
+            }
+            else
+            {
+                long long number{ 0 };
+                std::memcpy(&number, value, size_bytes);
+                needle = _mm256_set1_epi64x(number);
+            }
+
+            std::size_t index{ 0 };
+            for (; (index + lanes) <= count; index += lanes)
+            {
+                const __m256i block{ _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i *>(bytes + (index * size_bytes))) };
+
+                __m256i equal;
+                if constexpr (size_bytes == 1)
+                {
+                    equal = _mm256_cmpeq_epi8(block, needle);
+                }
+                else if constexpr (size_bytes == 2)
+                {
+                    equal = _mm256_cmpeq_epi16(block, needle);
+                }
+                else if constexpr (size_bytes == 4)
+                {
+                    equal = _mm256_cmpeq_epi32(block, needle);
+                }
+                else
+                {
+                    equal = _mm256_cmpeq_epi64(block, needle);
+                }
+
+                const unsigned mask{ static_cast<unsigned>(_mm256_movemask_epi8(equal)) };
+                if (mask != 0)
+                {
+                    return (index + (countTrailingZeros(mask) / size_bytes));
+                }
+            }
+
+            return index;
+        }
+
+#endif
+
+        // Bit i of the result is set if group[i] == value, for a group of 16 bytes.
+        // This is how swiss-table style hash maps probe 16 control bytes at once.
+        inline unsigned matchBytes16(const std::int8_t * group, const std::int8_t value) noexcept
+        {
+#if defined(UTILZ_SIMD_SSE2)
+            const __m128i block{ _mm_loadu_si128(reinterpret_cast<const __m128i *>(group)) };
+            const __m128i needle{ _mm_set1_epi8(static_cast<char>(value)) };
+            return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle)));
+#else
+            unsigned mask{ 0 };
+
+            for (unsigned i(0); i < 16; ++i)
+            {
+                if (group[i] == value)
+                {
+                    mask |= (1u << i);
+                }
+            }
+
+            return mask;
+#endif
+        }
+
+        // Returns the index of the first element equal to value, or count if there is none.
+        // Compares 16 (SSE2) or 32 (AVX2) bytes worth of elements per instruction.
+        template <typename T>
+        std::size_t findEqual(const T * first, const std::size_t count, const T & value) noexcept
+        {
+            static_assert(isScannable<T>);
+
+            std::size_t index{ 0 };
+
+#if defined(UTILZ_SIMD_SSE2)
+            const unsigned char * bytes{ reinterpret_cast<const unsigned char *>(first) };
+
+#if defined(UTILZ_SIMD_AVX2)
+            if (isAvx2Supported())
+            {
+                index = findEqualAvx2<sizeof(T)>(bytes, count, &value);
+            }
+            else
+#endif
+            {
+                index = findEqualSse2<sizeof(T)>(bytes, count, &value);
+            }
+#endif
+
+            // the match found above, whatever did not fill a register, or everything without SIMD
+            for (; index < count; ++index)
+            {
+                if (first[index] == value)
+                {
+                    return index;
+                }
+            }
+
+            return count;
+        }
+
+    } // namespace simd
+
+} // namespace utilz
+
+#endif // UTILZ_SIMD_HPP_INCLUDED
@@ -0,0 +1,413 @@
+#ifndef SMALL_VECTOR_HPP_INCLUDED
+#define SMALL_VECTOR_HPP_INCLUDED
+//
+// small-vector.hpp
+//
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace utilz
+{
+
+    // A std::vector replacement that holds the first inline_capacity elements inside the object
+    // itself, and only allocates once it grows beyond that.  Iterators are plain pointers.
+    //
+    // Use this for the many tiny containers that would otherwise each cost a heap allocation, or
+    // for containers that live inside arrays of other objects where locality matters.
+    template <typename T, std::size_t inline_capacity>
+    class SmallVector
+    {
+        static_assert(inline_capacity > 0, "SmallVector needs room for at least one element.");
+
+      public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = T &;
+        using const_reference = const T &;
+        using pointer = T *;
+        using const_pointer = const T *;
+        using iterator = T *;
+        using const_iterator = const T *;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        SmallVector() noexcept
+            : m_begin(inlineBegin())
+            , m_size(0)
+            , m_capacity(inline_capacity)
+        {}
+
+        SmallVector(const std::initializer_list<T> initList)
+            : SmallVector()
+        {
+            reserve(initList.size());
+
+            for (const T & value : initList)
+            {
+                push_back(value);
+            }
+        }
+
+        SmallVector(const SmallVector & other)
+            : SmallVector()
+        {
+            reserve(other.size());
+            std::uninitialized_copy(other.begin(), other.end(), m_begin);
+            m_size = other.m_size;
+        }
+
+        SmallVector(SmallVector && other) noexcept(std::is_nothrow_move_constructible_v<T>)
+            : SmallVector()
+        {
+            takeFrom(other);
+        }
+
+        SmallVector & operator=(const SmallVector & other)
+        {
+            if (this != &other)
+            {
+                SmallVector copy{ other };
+                clear();
+                releaseHeap();
+                takeFrom(copy);
+            }
+
+            return *this;
+        }
+
+        SmallVector & operator=(SmallVector && other) noexcept(
+            std::is_nothrow_move_constructible_v<T>)
+        {
+            if (this != &other)
+            {
+                clear();
+                releaseHeap();
+                takeFrom(other);
+            }
+
+            return *this;
+        }
+
+        ~SmallVector()
+        {
+            clear();
+            releaseHeap();
+        }
+
+        bool empty() const noexcept { return (0 == m_size); }
+        size_type size() const noexcept { return m_size; }
+        size_type capacity() const noexcept { return m_capacity; }
+
+        // true while nothing has been allocated
+        bool isInline() const noexcept { return (m_begin == inlineBegin()); }
+
+        static constexpr size_type inlineCapacity() noexcept { return inline_capacity; }
+
+        void clear() noexcept
+        {
+            std::destroy(begin(), end());
+            m_size = 0;
+        }
+
+        void reserve(const size_type count)
+        {
+            if (count > m_capacity)
+            {
+                reallocate(count);
+            }
+        }
+
+        // moves back inside the object if everything fits
+        void shrink_to_fit()
+        {
+            if (isInline() || (m_size == m_capacity))
+            {
+                return;
+            }
+
+            if (m_size <= inline_capacity)
+            {
+                T * const heap{ m_begin };
+                const size_type heapCapacity{ m_capacity };
+
+                relocate(heap, heap + m_size, inlineBegin());
+                m_begin = inlineBegin();
+                m_capacity = inline_capacity;
+                std::allocator<T>().deallocate(heap, heapCapacity);
+            }
+            else
+            {
+                reallocate(m_size);
+            }
+        }
+
+        reference operator[](const size_type index) noexcept { return m_begin[index]; }
+        const_reference operator[](const size_type index) const noexcept { return m_begin[index]; }
+
+        reference at(const size_type index)
+        {
+            if (index >= m_size)
+            {
+                throw std::out_of_range("SmallVector::at() - index out of range");
+            }
+
+            return m_begin[index];
+        }
+
+        const_reference at(const size_type index) const
+        {
+            if (index >= m_size)
+            {
+                throw std::out_of_range("SmallVector::at()const - index out of range");
+            }
+
+            return m_begin[index];
+        }
+
+        reference front() noexcept { return m_begin[0]; }
+        const_reference front() const noexcept { return m_begin[0]; }
+        reference back() noexcept { return m_begin[m_size - 1]; }
+        const_reference back() const noexcept { return m_begin[m_size - 1]; }
+
+        pointer data() noexcept { return m_begin; }
+        const_pointer data() const noexcept { return m_begin; }
+
+        template <typename... Args_t>
+        reference emplace_back(Args_t &&... args)
+        {
+            if (m_size == m_capacity)
+            {
+                // the args might refer to an element, so construct before moving everything
+                T value(std::forward<Args_t>(args)...);
+                reallocate(m_capacity * 2);
+                ::new (static_cast<void *>(m_begin + m_size)) T(std::move(value));
+            }
+            else
+            {
+                ::new (static_cast<void *>(m_begin + m_size)) T(std::forward<Args_t>(args)...);
+            }
+
+            ++m_size;
+            return back();
+        }
+
+        void push_back(const T & value) { emplace_back(value); }
+        void push_back(T && value) { emplace_back(std::move(value)); }
+
+        void pop_back() noexcept
+        {
+            --m_size;
+            std::destroy_at(m_begin + m_size);
+        }
+
+        template <typename... Args_t>
+        iterator emplace(const const_iterator position, Args_t &&... args)
+        {
+            const difference_type offset{ position - cbegin() };
+
+            if (position == cend())
+            {
+                emplace_back(std::forward<Args_t>(args)...);
+                return (begin() + offset);
+            }
+
+            T value(std::forward<Args_t>(args)...);
+
+            if (m_size == m_capacity)
+            {
+                reallocate(m_capacity * 2);
+            }
+
+            T * const iter{ begin() + offset };
+            ::new (static_cast<void *>(end())) T(std::move(back()));
+            ++m_size;
+            std::move_backward(iter, (end() - 2), (end() - 1));
+            *iter = std::move(value);
+            return iter;
+        }
+
+        iterator insert(const const_iterator position, const T & value)
+        {
+            return emplace(position, value);
+        }
+
+        iterator insert(const const_iterator position, T && value)
+        {
+            return emplace(position, std::move(value));
+        }
+
+        iterator erase(const const_iterator position) { return erase(position, (position + 1)); }
+
+        iterator erase(const const_iterator from, const const_iterator to)
+        {
+            T * const first{ begin() + (from - cbegin()) };
+            T * const last{ begin() + (to - cbegin()) };
+
+            if (first != last)
+            {
+                T * const newEnd{ std::move(last, end(), first) };
+                std::destroy(newEnd, end());
+                m_size -= static_cast<size_type>(last - first);
+            }
+
+            return first;
+        }
+
+        void swap(SmallVector & other)
+        {
+            SmallVector temp{ std::move(other) };
+            other = std::move(*this);
+            *this = std::move(temp);
+        }
+
+        iterator begin() noexcept { return m_begin; }
+        iterator end() noexcept { return (m_begin + m_size); }
+        const_iterator begin() const noexcept { return m_begin; }
+        const_iterator end() const noexcept { return (m_begin + m_size); }
+        const_iterator cbegin() const noexcept { return begin(); }
+        const_iterator cend() const noexcept { return end(); }
+
+        reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+        reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+        const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+        const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+        const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+        const_reverse_iterator crend() const noexcept { return rend(); }
+
+      private:
+        T * inlineBegin() noexcept { return std::launder(reinterpret_cast<T *>(m_inline)); }
+
+        const T * inlineBegin() const noexcept
+        {
+            return std::launder(reinterpret_cast<const T *>(m_inline));
+        }
+
+        // moves (or copies if moving could throw) into uninitialized memory and destroys the source
+        static void relocate(T * const first, T * const last, T * const destination)
+        {
+            if constexpr (
+                std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>)
+            {
+                std::uninitialized_move(first, last, destination);
+            }
+            else
+            {
+                std::uninitialized_copy(first, last, destination);
+            }
+
+            std::destroy(first, last);
+        }
+
+        void reallocate(const size_type newCapacity)
+        {
+            T * const heap{ std::allocator<T>().allocate(newCapacity) };
+
+            try
+            {
+                relocate(begin(), end(), heap);
+            }
+            catch (...)
+            {
+                std::allocator<T>().deallocate(heap, newCapacity);
+                throw;
+            }
+
+            releaseHeap();
+            m_begin = heap;
+            m_capacity = newCapacity;
+        }
+
+        // must be empty (all destroyed) before calling this
+        void releaseHeap() noexcept
+        {
+            if (!isInline())
+            {
+                std::allocator<T>().deallocate(m_begin, m_capacity);
+                m_begin = inlineBegin();
+                m_capacity = inline_capacity;
+            }
+        }
+
+        // this must be empty and inline, other is left empty and inline
+        void takeFrom(SmallVector & other)
+        {
+            if (other.isInline())
+            {
+                relocate(other.begin(), other.end(), m_begin);
+                m_size = other.m_size;
+            }
+            else
+            {
+                m_begin = other.m_begin;
+                m_size = other.m_size;
+                m_capacity = other.m_capacity;
+                other.m_begin = other.inlineBegin();
+                other.m_capacity = inline_capacity;
+            }
+
+            other.m_size = 0;
+        }
+
+      private:
+        alignas(T) unsigned char m_inline[sizeof(T) * inline_capacity];
+        T * m_begin;
+        size_type m_size;
+        size_type m_capacity;
+    };
+
+    //
+
+    template <typename T, std::size_t N>
+    bool operator==(const SmallVector<T, N> & left, const SmallVector<T, N> & right)
+    {
+        return std::equal(std::begin(left), std::end(left), std::begin(right), std::end(right));
+    }
+
+    template <typename T, std::size_t N>
+    bool operator!=(const SmallVector<T, N> & left, const SmallVector<T, N> & right)
+    {
+        return !(left == right);
+    }
+
+    template <typename T, std::size_t N>
+    bool operator<(const SmallVector<T, N> & left, const SmallVector<T, N> & right)
+    {
+        return std::lexicographical_compare(
+            std::begin(left), std::end(left), std::begin(right), std::end(right));
+    }
+
+    template <typename T, std::size_t N>
+    bool operator>(const SmallVector<T, N> & left, const SmallVector<T, N> & right)
+    {
+        return (right < left);
+    }
+
+    template <typename T, std::size_t N>
+    bool operator<=(const SmallVector<T, N> & left, const SmallVector<T, N> & right)
+    {
+        return !(left > right);
+    }
+
+    template <typename T, std::size_t N>
+    bool operator>=(const SmallVector<T, N> & left, const SmallVector<T, N> & right)
+    {
+        return !(left < right);
+    }
+
+    template <typename T, std::size_t N>
+    void swap(SmallVector<T, N> & left, SmallVector<T, N> & right)
+    {
+        left.swap(right);
+    }
+
+} // namespace utilz
+
+#endif // SMALL_VECTOR_HPP_INCLUDED
@@ -0,0 +1,136 @@
+#ifndef SNAPSHOT_FLAT_MAP_HPP_INCLUDED
+#define SNAPSHOT_FLAT_MAP_HPP_INCLUDED
+//
+// snapshot-flat-map.hpp
+//
+#include "utilz/flat-map.hpp"
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace utilz
+{
+
+    // A FlatMap for when many threads read all the time and something only rarely writes, like
+    // config that is read on every request but changes once a minute.
+    //
+    // The map itself is never changed once published.  Readers get the current one with
+    // std::atomic_load() of a shared_ptr and can keep using it for as long as they like, even
+    // after a newer one is published.  Writers copy the current map, change the copy, and then
+    // publish it with std::atomic_store().  Writers wait on each other so that no update is lost,
+    // and use update() to make many changes with only one copy.
+    //
+    // Readers never wait for a writer to copy or change a map, but they are not lock-free.  The
+    // standard libraries implement the shared_ptr atomics with a small lock that is held just
+    // long enough to copy the pointer and bump its count, and libstdc++ and MSVC pick that lock
+    // from one process wide pool by hashing the address.  So every load and store briefly locks,
+    // and unrelated SnapshotFlatMaps (or any other shared_ptr atomics) can contend on the same
+    // lock.  That is cheap next to copying a map, but take one snapshot() and do many lookups
+    // with it instead of calling find() in a hot loop.
+    template <typename key_t, typename data_t>
+    class SnapshotFlatMap
+    {
+      public:
+        using map_t = FlatMap<key_t, data_t>;
+        using snapshot_t = std::shared_ptr<const map_t>;
+
+        SnapshotFlatMap()
+            : m_writeMutex()
+            , m_current(std::make_shared<const map_t>())
+        {}
+
+        explicit SnapshotFlatMap(map_t map)
+            : m_writeMutex()
+            , m_current(std::make_shared<const map_t>(std::move(map)))
+        {}
+
+        // the mutex can't be copied or moved, use snapshot() and publish() instead
+        SnapshotFlatMap(const SnapshotFlatMap &) = delete;
+        SnapshotFlatMap(SnapshotFlatMap &&) = delete;
+
+        SnapshotFlatMap & operator=(const SnapshotFlatMap &) = delete;
+        SnapshotFlatMap & operator=(SnapshotFlatMap &&) = delete;
+
+        // Only waits for the brief pointer copy explained above, never for a writer's copy.
+        // Hold on to this to see one consistent version of the map across many lookups, instead
+        // of calling the lookups below that each load it again.
+        snapshot_t snapshot() const { return std::atomic_load(&m_current); }
+
+        std::size_t size() const { return snapshot()->size(); }
+        bool empty() const { return snapshot()->empty(); }
+
+        // returns a copy of the data so that it outlives the snapshot it came from
+        std::optional<data_t> find(const key_t & key) const
+        {
+            const snapshot_t map{ snapshot() };
+
+            const auto iter{ map->find(key) };
+            if (iter == std::end(*map))
+            {
+                return std::nullopt;
+            }
+
+            return iter->second;
+        }
+
+        bool exists(const key_t & key) const { return snapshot()->exists(key); }
+
+        // Calls func(map_t &) on a copy of the current map and then publishes that copy, so any
+        // number of changes made in func cost only one copy and one publish.  Returns whatever
+        // func does.  Nothing is published if func throws.  func must not call any writing
+        // functions of this map.
+        template <typename Func_t>
+        auto update(Func_t && func)
+        {
+            std::lock_guard<std::mutex> lock(m_writeMutex);
+
+            std::shared_ptr<map_t> copy{ std::make_shared<map_t>(*std::atomic_load(&m_current)) };
+
+            if constexpr (std::is_void_v<std::invoke_result_t<Func_t, map_t &>>)
+            {
+                std::forward<Func_t>(func)(*copy);
+                std::atomic_store(&m_current, snapshot_t(std::move(copy)));
+            }
+            else
+            {
+                auto result{ std::forward<Func_t>(func)(*copy) };
+                std::atomic_store(&m_current, snapshot_t(std::move(copy)));
+                return result;
+            }
+        }
+
+        // replaces everything without copying
+        void publish(map_t map)
+        {
+            snapshot_t next{ std::make_shared<const map_t>(std::move(map)) };
+
+            std::lock_guard<std::mutex> lock(m_writeMutex);
+            std::atomic_store(&m_current, std::move(next));
+        }
+
+        // each of these copies and publishes the whole map, use update() for more than one change
+        void insertOrAssign(const key_t & key, const data_t & data)
+        {
+            update([&](map_t & map) { map.insertOrAssign(key, data); });
+        }
+
+        void erase(const key_t & key)
+        {
+            update([&](map_t & map) { map.erase(key); });
+        }
+
+        void clear() { publish(map_t()); }
+
+      private:
+        std::mutex m_writeMutex;
+
+        // only ever touched with std::atomic_load() and std::atomic_store()
+        snapshot_t m_current;
+    };
+
+} // namespace utilz
+
+#endif // SNAPSHOT_FLAT_MAP_HPP_INCLUDED
@@ -0,0 +1,596 @@
+#ifndef SOA_FLAT_MAP_HPP_INCLUDED
+#define SOA_FLAT_MAP_HPP_INCLUDED
+//
+// soa-flat-map.hpp
+//
+#include "utilz/simd.hpp"
+#include "utilz/small-vector.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace utilz
+{
+
+    // The vector SoaFlatMap keeps each of its keys and values in.  std::vector<bool> packs its
+    // bools into bits and so has no data() or bool & for the iterators to point at, so bools are
+    // kept in a SmallVector instead.
+    template <typename T>
+    using SoaColumn =
+        std::conditional_t<std::is_same_v<T, bool>, SmallVector<bool, 16>, std::vector<T>>;
+
+    // Same as FlatMap but the keys and values are kept in two parallel vectors (structure of
+    // arrays) so that scanning keys never pulls the values into cache.  Use this when data_t is
+    // large compared to key_t.
+    //
+    // Iterators yield proxy pairs of references (std::pair<key_t &, data_t &>) instead of real
+    // pairs, so they work with range-for, ->first/->second, and most non-modifying algorithms, but
+    // not with algorithms that swap or sort through the iterators.
+    template <typename key_t, typename data_t>
+    class SoaFlatMap
+    {
+      public:
+        using value_t = std::pair<key_t, data_t>;
+        using key_container_t = SoaColumn<key_t>;
+        using data_container_t = SoaColumn<data_t>;
+
+      private:
+        template <bool is_const>
+        class SoaIterator
+        {
+          public:
+            using key_ref_t = std::conditional_t<is_const, const key_t &, key_t &>;
+            using data_ref_t = std::conditional_t<is_const, const data_t &, data_t &>;
+            using key_ptr_t = std::conditional_t<is_const, const key_t *, key_t *>;
+            using data_ptr_t = std::conditional_t<is_const, const data_t *, data_t *>;
+
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = value_t;
+            using difference_type = std::ptrdiff_t;
+            using reference = std::pair<key_ref_t, data_ref_t>;
+
+            // operator-> has to return something that lives long enough to have -> called on it
+            struct pointer
+            {
+                reference pair;
+                const reference * operator->() const noexcept { return &pair; }
+            };
+
+            SoaIterator() noexcept
+                : m_key(nullptr)
+                , m_data(nullptr)
+            {}
+
+            SoaIterator(const key_ptr_t key, const data_ptr_t data) noexcept
+                : m_key(key)
+                , m_data(data)
+            {}
+
+            // iterator to const_iterator
+            template <bool other_is_const, typename = std::enable_if_t<is_const && !other_is_const>>
+            SoaIterator(const SoaIterator<other_is_const> & other) noexcept
+                : m_key(other.m_key)
+                , m_data(other.m_data)
+            {}
+
+            reference operator*() const noexcept { return reference(*m_key, *m_data); }
+            pointer operator->() const noexcept { return pointer{ **this }; }
+
+            reference operator[](const difference_type offset) const noexcept
+            {
+                return *(*this + offset);
+            }
+
+            SoaIterator & operator++() noexcept { return (*this += 1); }
+            SoaIterator & operator--() noexcept { return (*this -= 1); }
+
+            SoaIterator operator++(int) noexcept
+            {
+                const SoaIterator before{ *this };
+                ++*this;
+                return before;
+            }
+
+            SoaIterator operator--(int) noexcept
+            {
+                const SoaIterator before{ *this };
+                --*this;
+                return before;
+            }
+
+            SoaIterator & operator+=(const difference_type offset) noexcept
+            {
+                m_key += offset;
+                m_data += offset;
+                return *this;
+            }
+
+            SoaIterator & operator-=(const difference_type offset) noexcept
+            {
+                return (*this += -offset);
+            }
+
+            SoaIterator operator+(const difference_type offset) const noexcept
+            {
+                SoaIterator iter{ *this };
+                return (iter += offset);
+            }
+
+            SoaIterator operator-(const difference_type offset) const noexcept
+            {
+                SoaIterator iter{ *this };
+                return (iter -= offset);
+            }
+
+            friend SoaIterator
+                operator+(const difference_type offset, const SoaIterator & iter) noexcept
+            {
+                return (iter + offset);
+            }
+
+            difference_type operator-(const SoaIterator & other) const noexcept
+            {
+                return (m_key - other.m_key);
+            }
+
+            bool operator==(const SoaIterator & other) const noexcept
+            {
+                return (m_key == other.m_key);
+            }
+
+            bool operator!=(const SoaIterator & other) const noexcept { return !(*this == other); }
+            bool operator<(const SoaIterator & other) const noexcept
+            {
+                return (m_key < other.m_key);
+            }
+
+            bool operator>(const SoaIterator & other) const noexcept { return (other < *this); }
+            bool operator<=(const SoaIterator & other) const noexcept { return !(*this > other); }
+            bool operator>=(const SoaIterator & other) const noexcept { return !(*this < other); }
+
+          private:
+            template <bool>
+            friend class SoaIterator;
+
+            friend class SoaFlatMap;
+
+            key_ptr_t m_key;
+            data_ptr_t m_data;
+        };
+
+      public:
+        using iterator_t = SoaIterator<false>;
+        using const_iterator_t = SoaIterator<true>;
+        using reverse_iterator_t = std::reverse_iterator<iterator_t>;
+        using const_reverse_iterator_t = std::reverse_iterator<const_iterator_t>;
+
+        SoaFlatMap()
+            : m_keys()
+            , m_values()
+        {}
+
+        SoaFlatMap(const SoaFlatMap &) = default;
+        SoaFlatMap(SoaFlatMap &&) = default;
+
+        SoaFlatMap & operator=(const SoaFlatMap &) = default;
+        SoaFlatMap & operator=(SoaFlatMap &&) = default;
+
+        bool empty() const noexcept { return m_keys.empty(); }
+        std::size_t size() const noexcept { return m_keys.size(); }
+
+        void clear() noexcept
+        {
+            m_keys.clear();
+            m_values.clear();
+        }
+
+        void reserve(const std::size_t count)
+        {
+            m_keys.reserve(count);
+            m_values.reserve(count);
+        }
+
+        std::size_t capacity() const noexcept
+        {
+            return std::min(m_keys.capacity(), m_values.capacity());
+        }
+
+        void shrinkToFit()
+        {
+            m_keys.shrink_to_fit();
+            m_values.shrink_to_fit();
+        }
+
+        // direct access to the parallel arrays, the same index refers to the same entry
+        const key_container_t & keys() const noexcept { return m_keys; }
+        const data_container_t & values() const noexcept { return m_values; }
+
+        data_t & operator[](const key_t & key)
+        {
+            const std::size_t index{ indexOf(key) };
+
+            if (index < m_keys.size())
+            {
+                return m_values[index];
+            }
+
+            append(key, data_t{});
+            return m_values.back();
+        }
+
+        data_t & at(const key_t & key)
+        {
+            const std::size_t index{ indexOf(key) };
+
+            if (index == m_keys.size())
+            {
+                throw std::out_of_range("SoaFlatMap::at() - key not found");
+            }
+
+            return m_values[index];
+        }
+
+        const data_t & at(const key_t & key) const
+        {
+            const std::size_t index{ indexOf(key) };
+
+            if (index == m_keys.size())
+            {
+                throw std::out_of_range("SoaFlatMap::at()const - key not found");
+            }
+
+            return m_values[index];
+        }
+
+        // duplicate keys maintained
+        void append(const value_t & pair) { append(pair.first, pair.second); }
+
+        void append(const key_t & key, const data_t & data)
+        {
+            m_keys.push_back(key);
+
+            try
+            {
+                m_values.push_back(data);
+            }
+            catch (...)
+            {
+                m_keys.pop_back();
+                throw;
+            }
+        }
+
+        // will erase all duplicate keys
+        void erase(const key_t & key)
+        {
+            std::size_t keep{ 0 };
+
+            for (std::size_t i(0); i < m_keys.size(); ++i)
+            {
+                if (key == m_keys[i])
+                {
+                    continue;
+                }
+
+                if (keep != i)
+                {
+                    m_keys[keep] = std::move(m_keys[i]);
+                    m_values[keep] = std::move(m_values[i]);
+                }
+
+                ++keep;
+            }
+
+            const auto keepOffset{ static_cast<std::ptrdiff_t>(keep) };
+            m_keys.erase(std::begin(m_keys) + keepOffset, std::end(m_keys));
+            m_values.erase(std::begin(m_values) + keepOffset, std::end(m_values));
+        }
+
+        iterator_t erase(const const_iterator_t & iter) { return erase(iter, std::next(iter)); }
+
+        iterator_t erase(const const_iterator_t & from, const const_iterator_t & to)
+        {
+            const auto fromOffset{ from - cbegin() };
+            const auto toOffset{ to - cbegin() };
+
+            m_keys.erase(std::begin(m_keys) + fromOffset, std::begin(m_keys) + toOffset);
+            m_values.erase(std::begin(m_values) + fromOffset, std::begin(m_values) + toOffset);
+
+            return (begin() + fromOffset);
+        }
+
+        iterator_t find(const key_t & key)
+        {
+            return (begin() + static_cast<std::ptrdiff_t>(indexOf(key)));
+        }
+
+        const_iterator_t find(const key_t & key) const
+        {
+            return (begin() + static_cast<std::ptrdiff_t>(indexOf(key)));
+        }
+
+        bool exists(const key_t & key) const { return (indexOf(key) < m_keys.size()); }
+
+        // removes all duplicate keys, keeping the first one appended
+        void sortAndUnique()
+        {
+            std::vector<std::size_t> indexes(m_keys.size());
+            std::iota(std::begin(indexes), std::end(indexes), std::size_t(0));
+
+            std::stable_sort(
+                std::begin(indexes),
+                std::end(indexes),
+                [&](const std::size_t a, const std::size_t b) { return (m_keys[a] < m_keys[b]); });
+
+            indexes.erase(
+                std::unique(
+                    std::begin(indexes),
+                    std::end(indexes),
+                    [&](const std::size_t a, const std::size_t b) {
+                        return (m_keys[a] == m_keys[b]);
+                    }),
+                std::end(indexes));
+
+            key_container_t keys;
+            data_container_t values;
+            keys.reserve(indexes.size());
+            values.reserve(indexes.size());
+
+            for (const std::size_t index : indexes)
+            {
+                keys.push_back(std::move(m_keys[index]));
+                values.push_back(std::move(m_values[index]));
+            }
+
+            m_keys = std::move(keys);
+            m_values = std::move(values);
+        }
+
+        iterator_t begin() noexcept { return iterator_t(m_keys.data(), m_values.data()); }
+        iterator_t end() noexcept { return (begin() + static_cast<std::ptrdiff_t>(size())); }
+
+        const_iterator_t begin() const noexcept
+        {
+            return const_iterator_t(m_keys.data(), m_values.data());
+        }
+
+        const_iterator_t end() const noexcept
+        {
+            return (begin() + static_cast<std::ptrdiff_t>(size()));
+        }
+
+        const_iterator_t cbegin() const noexcept { return begin(); }
+        const_iterator_t cend() const noexcept { return end(); }
+
+        reverse_iterator_t rbegin() noexcept { return reverse_iterator_t(end()); }
+        reverse_iterator_t rend() noexcept { return reverse_iterator_t(begin()); }
+
+        const_reverse_iterator_t rbegin() const noexcept { return const_reverse_iterator_t(end()); }
+        const_reverse_iterator_t rend() const noexcept { return const_reverse_iterator_t(begin()); }
+
+        const_reverse_iterator_t crbegin() const noexcept { return rbegin(); }
+        const_reverse_iterator_t crend() const noexcept { return rend(); }
+
+        // clang-format off
+        template<typename T, typename U>
+        friend bool
+            operator==(const SoaFlatMap<T, U> & left, const SoaFlatMap<T, U> & right);
+
+        template<typename T, typename U>
+        friend bool
+            operator<(const SoaFlatMap<T, U> & left, const SoaFlatMap<T, U> & right);
+        // clang-format on
+
+      private:
+        // returns size() if not found, only touches the keys, and uses SIMD for integers and enums
+        std::size_t indexOf(const key_t & key) const
+        {
+            const std::size_t count{ m_keys.size() };
+
+            if constexpr (simd::isScannable<key_t>)
+            {
+                return simd::findEqual(m_keys.data(), count, key);
+            }
+
+            for (std::size_t i(0); i < count; ++i)
+            {
+                if (key == m_keys[i])
+                {
+                    return i;
+                }
+            }
+
+            return count;
+        }
+
+        // the order compares need, by key and then by value, without moving anything
+        std::vector<std::size_t> sortedIndexes() const
+        {
+            std::vector<std::size_t> indexes(m_keys.size());
+            std::iota(std::begin(indexes), std::end(indexes), std::size_t(0));
+
+            std::sort(
+                std::begin(indexes),
+                std::end(indexes),
+                [&](const std::size_t a, const std::size_t b) {
+                    if (m_keys[a] < m_keys[b])
+                    {
+                        return true;
+                    }
+
+                    if (m_keys[b] < m_keys[a])
+                    {
+                        return false;
+                    }
+
+                    return (m_values[a] < m_values[b]);
+                });
+
+            return indexes;
+        }
+
+      private:
+        key_container_t m_keys;
+        data_container_t m_values;
+    };
+
+    //
+
+    template <typename key_t, typename data_t>
+    bool operator==(const SoaFlatMap<key_t, data_t> & left, const SoaFlatMap<key_t, data_t> & right)
+    {
+        if (left.size() != right.size())
+        {
+            return false;
+        }
+
+        const std::vector<std::size_t> leftIndexes{ left.sortedIndexes() };
+        const std::vector<std::size_t> rightIndexes{ right.sortedIndexes() };
+
+        for (std::size_t i(0); i < leftIndexes.size(); ++i)
+        {
+            const std::size_t l{ leftIndexes[i] };
+            const std::size_t r{ rightIndexes[i] };
+
+            if (!(left.m_keys[l] == right.m_keys[r]) || !(left.m_values[l] == right.m_values[r]))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    template <typename key_t, typename data_t>
+    bool operator!=(const SoaFlatMap<key_t, data_t> & left, const SoaFlatMap<key_t, data_t> & right)
+    {
+        return !(left == right);
+    }
+
+    template <typename key_t, typename data_t>
+    bool operator<(const SoaFlatMap<key_t, data_t> & left, const SoaFlatMap<key_t, data_t> & right)
+    {
+        const std::vector<std::size_t> leftIndexes{ left.sortedIndexes() };
+        const std::vector<std::size_t> rightIndexes{ right.sortedIndexes() };
+
+        return std::lexicographical_compare(
+            std::begin(leftIndexes),
+            std::end(leftIndexes),
+            std::begin(rightIndexes),
+            std::end(rightIndexes),
+            [&](const std::size_t l, const std::size_t r) {
+                if (left.m_keys[l] < right.m_keys[r])
+                {
+                    return true;
+                }
+
+                if (right.m_keys[r] < left.m_keys[l])
+                {
+                    return false;
+                }
+
+                return (left.m_values[l] < right.m_values[r]);
+            });
+    }
+
+    template <typename key_t, typename data_t>
+    bool operator>(const SoaFlatMap<key_t, data_t> & left, const SoaFlatMap<key_t, data_t> & right)
+    {
+        return (right < left);
+    }
+
+    template <typename key_t, typename data_t>
+    bool operator<=(const SoaFlatMap<key_t, data_t> & left, const SoaFlatMap<key_t, data_t> & right)
+    {
+        return !(left > right);
+    }
+
+    template <typename key_t, typename data_t>
+    bool operator>=(const SoaFlatMap<key_t, data_t> & left, const SoaFlatMap<key_t, data_t> & right)
+    {
+        return !(left < right);
+    }
+
+    //
+
+    template <typename key_t, typename data_t>
+    auto begin(SoaFlatMap<key_t, data_t> & map) noexcept
+    {
+        return map.begin();
+    }
+
+    template <typename key_t, typename data_t>
+    auto begin(const SoaFlatMap<key_t, data_t> & map) noexcept
+    {
+        return map.begin();
+    }
+
+    template <typename key_t, typename data_t>
+    auto cbegin(const SoaFlatMap<key_t, data_t> & map) noexcept
+    {
+        return begin(map);
+    }
+
+    template <typename key_t, typename data_t>
+    auto rbegin(SoaFlatMap<key_t, data_t> & map) noexcept
+    {
+        return map.rbegin();
+    }
+
+    template <typename key_t, typename data_t>
+    auto rbegin(const SoaFlatMap<key_t, data_t> & map) noexcept
+    {
+        return map.rbegin();
+    }
+
+    template <typename key_t, typename data_t>
+    auto crbegin(const SoaFlatMap<key_t, data_t> & map) noexcept
+    {
+        return rbegin(map);
+    }
+
+    template <typename key_t, typename data_t>
+    auto end(SoaFlatMap<key_t, data_t> & map) noexcept
+    {
+        return map.end();
+    }
+
+    template <typename key_t, typename data_t>
+    auto end(const SoaFlatMap<key_t, data_t> & map) noexcept
+    {
+        return map.end();
+    }
+
+    template <typename key_t, typename data_t>
+    auto cend(const SoaFlatMap<key_t, data_t> & map) noexcept
+    {
+        return end(map);
+    }
+
+    template <typename key_t, typename data_t>
+    auto rend(SoaFlatMap<key_t, data_t> & map) noexcept
+    {
+        return map.rend();
+    }
+
+    template <typename key_t, typename data_t>
+    auto rend(const SoaFlatMap<key_t, data_t> & map) noexcept
+    {
+        return map.rend();
+    }
+
+    template <typename key_t, typename data_t>
+    auto crend(const SoaFlatMap<key_t, data_t> & map) noexcept
+    {
+        return rend(map);
+    }
+
+} // namespace utilz
+
+#endif // SOA_FLAT_MAP_HPP_INCLUDED
@@ -0,0 +1,591 @@
+#ifndef SORTED_FLAT_MAP_HPP_INCLUDED
+#define SORTED_FLAT_MAP_HPP_INCLUDED
+//
+// sorted-flat-map.hpp
+//
+#include "utilz/small-vector.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace utilz
+{
+
+    // A FlatMap that keeps its vector sorted by key so that lookups are binary searches.
+    //
+    // insert() and operator[] keep the vector sorted and the keys unique.  append() is for bulk
+    // loads, it just pushes to the back and is expected to be followed by one sortAndUnique().
+    // Until then, lookups binary search the sorted front and then linearly scan the appended tail,
+    // so they are always correct and only fast when there is no tail.
+    //
+    // For write-heavy use, construct with a tail limit and use append() instead of insert().
+    // Appends are then O(1), and whenever the tail grows past the limit it is sorted on its own
+    // and merged into the front, which keeps lookups at O(log n) plus a scan of a short tail.
+    //
+    // Maps are compared by what lookups would find, in key order, so the order of appends and
+    // any duplicates that lookups never see do not matter.  Only operator< needs operator< of the
+    // data, just like comparing two std::pairs.
+    //
+    // Changing keys through iterators will break the sort order, so don't.
+    template <typename key_t, typename data_t>
+    class SortedFlatMap
+    {
+      public:
+        using value_t = std::pair<key_t, data_t>;
+        using container_t = std::vector<value_t>;
+        using iterator_t = typename container_t::iterator;
+        using const_iterator_t = typename container_t::const_iterator;
+        using reverse_iterator_t = std::reverse_iterator<iterator_t>;
+        using const_reverse_iterator_t = std::reverse_iterator<const_iterator_t>;
+
+        SortedFlatMap()
+            : m_vector()
+            , m_sortedCount(0)
+            , m_tailLimit(0)
+        {}
+
+        // append() will call sortAndUnique() when there are more than tailLimit appended entries
+        explicit SortedFlatMap(const std::size_t tailLimit)
+            : m_vector()
+            , m_sortedCount(0)
+            , m_tailLimit(tailLimit)
+        {}
+
+        SortedFlatMap(const SortedFlatMap &) = default;
+        SortedFlatMap(SortedFlatMap &&) = default;
+
+        SortedFlatMap & operator=(const SortedFlatMap &) = default;
+        SortedFlatMap & operator=(SortedFlatMap &&) = default;
+
+        bool empty() const noexcept { return m_vector.empty(); }
+        std::size_t size() const noexcept { return m_vector.size(); }
+
+        void clear() noexcept
+        {
+            m_vector.clear();
+            m_sortedCount = 0;
+        }
+
+        void reserve(const std::size_t count) { m_vector.reserve(count); }
+        std::size_t capacity() const noexcept { return m_vector.capacity(); }
+        void shrinkToFit() { m_vector.shrink_to_fit(); }
+
+        // true if nothing has been appended since the last sortAndUnique()
+        bool isSorted() const noexcept { return (m_sortedCount == m_vector.size()); }
+
+        std::size_t tailSize() const noexcept { return (m_vector.size() - m_sortedCount); }
+
+        // zero means append() never merges on its own
+        std::size_t tailLimit() const noexcept { return m_tailLimit; }
+        void tailLimit(const std::size_t limit) noexcept { m_tailLimit = limit; }
+
+        // only constructs a data_t when the key is not found
+        data_t & operator[](const key_t & key) { return tryEmplace(key).first->second; }
+
+        data_t & at(const key_t & key)
+        {
+            const iterator_t iter{ find(key) };
+
+            if (iter == std::end(m_vector))
+            {
+                throw std::out_of_range("SortedFlatMap::at() - key not found");
+            }
+
+            return iter->second;
+        }
+
+        const data_t & at(const key_t & key) const
+        {
+            const const_iterator_t iter{ find(key) };
+
+            if (iter == std::end(m_vector))
+            {
+                throw std::out_of_range("SortedFlatMap::at()const - key not found");
+            }
+
+            return iter->second;
+        }
+
+        // keeps the order, does nothing if the key already exists, returns (iter, was_inserted)
+        std::pair<iterator_t, bool> insert(const key_t & key, const data_t & data)
+        {
+            return tryEmplace(key, data);
+        }
+
+        std::pair<iterator_t, bool> insert(const value_t & pair)
+        {
+            return insert(pair.first, pair.second);
+        }
+
+        // duplicate keys maintained and the order is not, see sortAndUnique() and tailLimit()
+        void append(const value_t & pair) { append(pair.first, pair.second); }
+
+        void append(const key_t & key, const data_t & data)
+        {
+            m_vector.emplace_back(key, data);
+
+            if ((m_tailLimit > 0) && (tailSize() > m_tailLimit))
+            {
+                sortAndUnique();
+            }
+        }
+
+        // will erase all duplicate keys
+        void erase(const key_t & key)
+        {
+            m_vector.erase(
+                std::remove_if(
+                    sortedEnd(),
+                    std::end(m_vector),
+                    [&](const value_t & pair) { return (key == pair.first); }),
+                std::end(m_vector));
+
+            const iterator_t iter{ lowerBound(key) };
+            if ((iter != sortedEnd()) && (iter->first == key))
+            {
+                m_vector.erase(iter);
+                --m_sortedCount;
+            }
+        }
+
+        iterator_t erase(const const_iterator_t & iter) { return erase(iter, std::next(iter)); }
+
+        iterator_t erase(const const_iterator_t & from, const const_iterator_t & to)
+        {
+            const const_iterator_t sortedEndIter{ std::cbegin(m_vector) + sortedDistance() };
+
+            if (from < sortedEndIter)
+            {
+                m_sortedCount -= static_cast<std::size_t>(std::min(to, sortedEndIter) - from);
+            }
+
+            return m_vector.erase(from, to);
+        }
+
+        iterator_t find(const key_t & key)
+        {
+            const iterator_t iter{ lowerBound(key) };
+
+            if ((iter != sortedEnd()) && (iter->first == key))
+            {
+                return iter;
+            }
+
+            return findInTail(key);
+        }
+
+        const_iterator_t find(const key_t & key) const
+        {
+            const const_iterator_t iter{ lowerBound(key) };
+
+            if ((iter != sortedEnd()) && (iter->first == key))
+            {
+                return iter;
+            }
+
+            return findInTail(key);
+        }
+
+        bool exists(const key_t & key) const { return (find(key) != std::end(m_vector)); }
+
+        // these only search the sorted part, which is everything after sortAndUnique()
+        iterator_t lowerBound(const key_t & key)
+        {
+            return std::lower_bound(std::begin(m_vector), sortedEnd(), key, KeyLess());
+        }
+
+        const_iterator_t lowerBound(const key_t & key) const
+        {
+            return std::lower_bound(std::begin(m_vector), sortedEnd(), key, KeyLess());
+        }
+
+        iterator_t upperBound(const key_t & key)
+        {
+            return std::upper_bound(std::begin(m_vector), sortedEnd(), key, KeyLess());
+        }
+
+        const_iterator_t upperBound(const key_t & key) const
+        {
+            return std::upper_bound(std::begin(m_vector), sortedEnd(), key, KeyLess());
+        }
+
+        // Removes all duplicate keys, keeping the first one inserted or appended.
+        // The front is already sorted, so only the tail is sorted and then the two are merged,
+        // which is O(t log t + n) instead of sorting all n.
+        void sortAndUnique()
+        {
+            if (isSorted())
+            {
+                return;
+            }
+
+            const iterator_t tailBegin{ sortedEnd() };
+            std::stable_sort(tailBegin, std::end(m_vector), KeyLess());
+            std::inplace_merge(std::begin(m_vector), tailBegin, std::end(m_vector), KeyLess());
+
+            m_vector.erase(
+                std::unique(
+                    std::begin(m_vector),
+                    std::end(m_vector),
+                    [](const value_t & left, const value_t & right) {
+                        return (left.first == right.first);
+                    }),
+                std::end(m_vector));
+
+            m_sortedCount = m_vector.size();
+        }
+
+        constexpr iterator_t begin() noexcept { return std::begin(m_vector); }
+        constexpr iterator_t end() noexcept { return std::end(m_vector); }
+
+        constexpr const_iterator_t begin() const noexcept { return std::begin(m_vector); }
+        constexpr const_iterator_t end() const noexcept { return std::end(m_vector); }
+
+        constexpr const_iterator_t cbegin() const noexcept { return begin(); }
+        constexpr const_iterator_t cend() const noexcept { return end(); }
+
+        constexpr reverse_iterator_t rbegin() noexcept { return reverse_iterator_t(end()); }
+        constexpr reverse_iterator_t rend() noexcept { return reverse_iterator_t(begin()); }
+
+        constexpr const_reverse_iterator_t rbegin() const noexcept
+        {
+            return const_reverse_iterator_t(end());
+        }
+
+        constexpr const_reverse_iterator_t rend() const noexcept
+        {
+            return const_reverse_iterator_t(begin());
+        }
+
+        constexpr const_reverse_iterator_t crbegin() const noexcept { return rbegin(); }
+        constexpr const_reverse_iterator_t crend() const noexcept { return rend(); }
+
+        // clang-format off
+        template<typename T, typename U>
+        friend bool
+            operator==(const SortedFlatMap<T, U> & left, const SortedFlatMap<T, U> & right);
+
+        template<typename T, typename U>
+        friend bool
+            operator<(const SortedFlatMap<T, U> & left, const SortedFlatMap<T, U> & right);
+        // clang-format on
+
+      private:
+        // compares keys only, so values never need operator<
+        struct KeyLess
+        {
+            bool operator()(const value_t & left, const value_t & right) const
+            {
+                return (left.first < right.first);
+            }
+
+            bool operator()(const value_t & pair, const key_t & key) const
+            {
+                return (pair.first < key);
+            }
+
+            bool operator()(const key_t & key, const value_t & pair) const
+            {
+                return (key < pair.first);
+            }
+        };
+
+        typename container_t::difference_type sortedDistance() const noexcept
+        {
+            return static_cast<typename container_t::difference_type>(m_sortedCount);
+        }
+
+        iterator_t sortedEnd() noexcept { return (std::begin(m_vector) + sortedDistance()); }
+
+        const_iterator_t sortedEnd() const noexcept
+        {
+            return (std::begin(m_vector) + sortedDistance());
+        }
+
+        iterator_t findInTail(const key_t & key)
+        {
+            return std::find_if(sortedEnd(), std::end(m_vector), [&](const value_t & pair) {
+                return (pair.first == key);
+            });
+        }
+
+        const_iterator_t findInTail(const key_t & key) const
+        {
+            return std::find_if(sortedEnd(), std::end(m_vector), [&](const value_t & pair) {
+                return (pair.first == key);
+            });
+        }
+
+        // insert() and operator[], with the data constructed from dataArgs only if inserting
+        template <typename... Args_t>
+        std::pair<iterator_t, bool> tryEmplace(const key_t & key, Args_t &&... dataArgs)
+        {
+            const iterator_t iter{ lowerBound(key) };
+
+            if ((iter != sortedEnd()) && (iter->first == key))
+            {
+                return { iter, false };
+            }
+
+            const iterator_t tailIter{ findInTail(key) };
+            if (tailIter != std::end(m_vector))
+            {
+                return { tailIter, false };
+            }
+
+            const iterator_t inserted{ m_vector.emplace(
+                iter,
+                std::piecewise_construct,
+                std::forward_as_tuple(key),
+                std::forward_as_tuple(std::forward<Args_t>(dataArgs)...)) };
+
+            ++m_sortedCount;
+            return { inserted, true };
+        }
+
+        // Walks what lookups see in key order without copying anything, for the compares.
+        // The sorted front is merged with pointers to the tail sorted by key, and any key that
+        // was already seen is skipped, so the front wins and then the first appended.  Only the
+        // tail is ever sorted, and up to 32 tail entries are sorted without allocating.
+        class OrderedView
+        {
+          public:
+            explicit OrderedView(const SortedFlatMap & map)
+                : m_front(std::begin(map.m_vector))
+                , m_frontEnd(map.sortedEnd())
+                , m_tail()
+                , m_tailIndex(0)
+                , m_previous(nullptr)
+            {
+                m_tail.reserve(map.tailSize());
+                for (auto iter(map.sortedEnd()); iter != std::end(map.m_vector); ++iter)
+                {
+                    m_tail.push_back(&*iter);
+                }
+
+                std::stable_sort(
+                    std::begin(m_tail),
+                    std::end(m_tail),
+                    [](const value_t * left, const value_t * right) {
+                        return (left->first < right->first);
+                    });
+            }
+
+            OrderedView(const OrderedView &) = delete;
+            OrderedView & operator=(const OrderedView &) = delete;
+
+            // returns nullptr after the last one
+            const value_t * next()
+            {
+                while ((m_front != m_frontEnd) || (m_tailIndex < m_tail.size()))
+                {
+                    const bool isFromFront{ (m_front != m_frontEnd) &&
+                                            ((m_tailIndex == m_tail.size()) ||
+                                             !(m_tail[m_tailIndex]->first < m_front->first)) };
+
+                    const value_t * const pair{ isFromFront ? &*m_front++
+                                                            : m_tail[m_tailIndex++] };
+
+                    // both are sorted, so not less than the one before means the same key
+                    if ((nullptr == m_previous) || (m_previous->first < pair->first))
+                    {
+                        m_previous = pair;
+                        return pair;
+                    }
+                }
+
+                return nullptr;
+            }
+
+          private:
+            const_iterator_t m_front;
+            const_iterator_t m_frontEnd;
+            SmallVector<const value_t *, 32> m_tail;
+            std::size_t m_tailIndex;
+            const value_t * m_previous;
+        };
+
+      private:
+        container_t m_vector;
+
+        // everything before this is sorted by key and unique, everything after was appended
+        std::size_t m_sortedCount;
+
+        std::size_t m_tailLimit;
+    };
+
+    //
+
+    template <typename key_t, typename data_t>
+    bool operator==(
+        const SortedFlatMap<key_t, data_t> & left, const SortedFlatMap<key_t, data_t> & right)
+    {
+        if (left.isSorted() && right.isSorted() && (left.size() != right.size()))
+        {
+            return false;
+        }
+
+        typename SortedFlatMap<key_t, data_t>::OrderedView leftView(left);
+        typename SortedFlatMap<key_t, data_t>::OrderedView rightView(right);
+
+        while (true)
+        {
+            const auto * const leftPair{ leftView.next() };
+            const auto * const rightPair{ rightView.next() };
+
+            if ((nullptr == leftPair) || (nullptr == rightPair))
+            {
+                return (leftPair == rightPair);
+            }
+
+            if (!(leftPair->first == rightPair->first) || !(leftPair->second == rightPair->second))
+            {
+                return false;
+            }
+        }
+    }
+
+    template <typename key_t, typename data_t>
+    bool operator!=(
+        const SortedFlatMap<key_t, data_t> & left, const SortedFlatMap<key_t, data_t> & right)
+    {
+        return !(left == right);
+    }
+
+    template <typename key_t, typename data_t>
+    bool operator<(
+        const SortedFlatMap<key_t, data_t> & left, const SortedFlatMap<key_t, data_t> & right)
+    {
+        typename SortedFlatMap<key_t, data_t>::OrderedView leftView(left);
+        typename SortedFlatMap<key_t, data_t>::OrderedView rightView(right);
+
+        // lexicographic, with each pair compared like std::pair does
+        while (true)
+        {
+            const auto * const leftPair{ leftView.next() };
+            const auto * const rightPair{ rightView.next() };
+
+            if (nullptr == rightPair)
+            {
+                return false;
+            }
+
+            if (nullptr == leftPair)
+            {
+                return true;
+            }
+
+            if (*leftPair < *rightPair)
+            {
+                return true;
+            }
+
+            if (*rightPair < *leftPair)
+            {
+                return false;
+            }
+        }
+    }
+
+    template <typename key_t, typename data_t>
+    bool operator>(
+        const SortedFlatMap<key_t, data_t> & left, const SortedFlatMap<key_t, data_t> & right)
+    {
+        return (right < left);
+    }
+
+    template <typename key_t, typename data_t>
+    bool operator<=(
+        const SortedFlatMap<key_t, data_t> & left, const SortedFlatMap<key_t, data_t> & right)
+    {
+        return !(left > right);
+    }
+
+    template <typename key_t, typename data_t>
+    bool operator>=(
+        const SortedFlatMap<key_t, data_t> & left, const SortedFlatMap<key_t, data_t> & right)
+    {
+        return !(left < right);
+    }
+
+    //
+
+    template <typename key_t, typename data_t>
+    constexpr auto begin(SortedFlatMap<key_t, data_t> & map) noexcept
+    {
+        return map.begin();
+    }
+
+    template <typename key_t, typename data_t>
+    constexpr auto begin(const SortedFlatMap<key_t, data_t> & map) noexcept
+    {
+        return map.begin();
+    }
+
+    template <typename key_t, typename data_t>
+    constexpr auto cbegin(const SortedFlatMap<key_t, data_t> & map) noexcept
+    {
+        return begin(map);
+    }
+
+    template <typename key_t, typename data_t>
+    constexpr auto rbegin(SortedFlatMap<key_t, data_t> & map) noexcept
+    {
+        return map.rbegin();
+    }
+
+    template <typename key_t, typename data_t>
+    constexpr auto rbegin(const SortedFlatMap<key_t, data_t> & map) noexcept
+    {
+        return map.rbegin();
+    }
+
+    template <typename key_t, typename data_t>
+    constexpr auto crbegin(const SortedFlatMap<key_t, data_t> & map) noexcept
+    {
+        return rbegin(map);
+    }
+
+    template <typename key_t, typename data_t>
+    constexpr auto end(SortedFlatMap<key_t, data_t> & map) noexcept
+    {
+        return map.end();
+    }
+
+    template <typename key_t, typename data_t>
+    constexpr auto end(const SortedFlatMap<key_t, data_t> & map) noexcept
+    {
+        return map.end();
+    }
+
+    template <typename key_t, typename data_t>
+    constexpr auto cend(const SortedFlatMap<key_t, data_t> & map) noexcept
+    {
+        return end(map);
+    }
+
+    template <typename key_t, typename data_t>
+    constexpr auto rend(SortedFlatMap<key_t, data_t> & map) noexcept
+    {
+        return map.rend();
+    }
+
+    template <typename key_t, typename data_t>
+    constexpr auto rend(const SortedFlatMap<key_t, data_t> & map) noexcept
+    {
+        return map.rend();
+    }
+
+    template <typename key_t, typename data_t>
+    constexpr auto crend(const SortedFlatMap<key_t, data_t> & map) noexcept
+    {
+        return rend(map);
+    }
+
+} // namespace utilz
+
+#endif // SORTED_FLAT_MAP_HPP_INCLUDED
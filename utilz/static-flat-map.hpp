@@ -0,0 +1,149 @@
+#ifndef STATIC_FLAT_MAP_HPP_INCLUDED
+#define STATIC_FLAT_MAP_HPP_INCLUDED
+//
+// static-flat-map.hpp
+//
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+
+namespace utilz
+{
+
+    // A read-only map that is built and sorted entirely at compile time, for the maps that are
+    // only ever filled once from constant tables.  Make it constexpr and there is no construction
+    // at runtime at all, the sorted arrays end up in read-only data.
+    //
+    //  constexpr auto opcodes{ makeStaticFlatMap<std::string_view, int>(
+    //      { { "load", 1 }, { "store", 2 }, { "jump", 3 } }) };
+    //
+    //  static_assert(opcodes.at("store") == 2);
+    //
+    // Keys and values are kept in two parallel arrays (see SoaFlatMap) so that the binary search
+    // only touches keys, and the search is branchless so that its loop always runs the same
+    // number of times for a given size.  key_t and data_t must be literal types (numbers, enums,
+    // std::string_view, etc.) and key_t needs operator<.
+    //
+    // Duplicate keys are a compile error when constexpr, or throw std::runtime_error if not.
+    // Sorting is a simple insertion sort, which is fine for the hundreds of entries this is for.
+    template <typename key_t, typename data_t, std::size_t size_count>
+    class StaticFlatMap
+    {
+        static_assert(size_count > 0, "StaticFlatMap needs at least one entry.");
+
+      public:
+        using value_t = std::pair<key_t, data_t>;
+        using key_container_t = std::array<key_t, size_count>;
+        using data_container_t = std::array<data_t, size_count>;
+
+        constexpr explicit StaticFlatMap(const value_t (&pairs)[size_count])
+            : StaticFlatMap(pairs, sortedOrder(pairs), std::make_index_sequence<size_count>())
+        {}
+
+        constexpr bool empty() const noexcept { return false; }
+        constexpr std::size_t size() const noexcept { return size_count; }
+
+        // both sorted by key
+        constexpr const key_container_t & keys() const noexcept { return m_keys; }
+        constexpr const data_container_t & values() const noexcept { return m_values; }
+
+        constexpr const data_t & at(const key_t & key) const
+        {
+            const std::size_t index{ indexOf(key) };
+
+            if (index == size_count)
+            {
+                throw std::out_of_range("StaticFlatMap::at() - key not found");
+            }
+
+            return m_values[index];
+        }
+
+        constexpr bool exists(const key_t & key) const { return (indexOf(key) < size_count); }
+
+        // returns size() if not found, otherwise the index into keys() and values()
+        constexpr std::size_t indexOf(const key_t & key) const
+        {
+            std::size_t first{ 0 };
+            std::size_t length{ size_count };
+
+            while (length > 1)
+            {
+                const std::size_t half{ length / 2 };
+                first = ((m_keys[first + half] < key) ? (first + half) : first);
+                length -= half;
+            }
+
+            if (m_keys[first] < key)
+            {
+                ++first;
+            }
+
+            if ((first < size_count) && !(key < m_keys[first]))
+            {
+                return first;
+            }
+
+            return size_count;
+        }
+
+      private:
+        template <std::size_t... indexes>
+        constexpr StaticFlatMap(
+            const value_t (&pairs)[size_count],
+            const std::array<std::size_t, size_count> & order,
+            std::index_sequence<indexes...>)
+            : m_keys{ { pairs[order[indexes]].first... } }
+            , m_values{ { pairs[order[indexes]].second... } }
+        {}
+
+        // Sorts indexes instead of the pairs because std::pair can't be assigned in a constexpr
+        // function until C++20, and the pairs are only ever copied once that way.
+        static constexpr std::array<std::size_t, size_count>
+            sortedOrder(const value_t (&pairs)[size_count])
+        {
+            std::array<std::size_t, size_count> order{};
+
+            for (std::size_t i(0); i < size_count; ++i)
+            {
+                std::size_t position{ i };
+
+                while ((position > 0) && (pairs[i].first < pairs[order[position - 1]].first))
+                {
+                    order[position] = order[position - 1];
+                    --position;
+                }
+
+                order[position] = i;
+            }
+
+            for (std::size_t i(1); i < size_count; ++i)
+            {
+                if (!(pairs[order[i - 1]].first < pairs[order[i]].first))
+                {
+                    throw std::runtime_error("StaticFlatMap - duplicate key");
+                }
+            }
+
+            return order;
+        }
+
+      private:
+        key_container_t m_keys;
+        data_container_t m_values;
+    };
+
+    //
+
+    // exists so that the size does not have to be counted and written out
+    template <typename key_t, typename data_t, std::size_t size_count>
+    constexpr StaticFlatMap<key_t, data_t, size_count>
+        makeStaticFlatMap(const std::pair<key_t, data_t> (&pairs)[size_count])
+    {
+        return StaticFlatMap<key_t, data_t, size_count>(pairs);
+    }
+
+} // namespace utilz
+
+#endif // STATIC_FLAT_MAP_HPP_INCLUDED